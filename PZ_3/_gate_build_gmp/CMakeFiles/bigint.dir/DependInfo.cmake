@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/PZ_3/src/bigint.cpp" "CMakeFiles/bigint.dir/src/bigint.cpp.o" "gcc" "CMakeFiles/bigint.dir/src/bigint.cpp.o.d"
+  "/root/repo/PZ_3/src/bigint_gmp.cpp" "CMakeFiles/bigint.dir/src/bigint_gmp.cpp.o" "gcc" "CMakeFiles/bigint.dir/src/bigint_gmp.cpp.o.d"
+  "/root/repo/PZ_3/src/bigint_stats.cpp" "CMakeFiles/bigint.dir/src/bigint_stats.cpp.o" "gcc" "CMakeFiles/bigint.dir/src/bigint_stats.cpp.o.d"
+  "/root/repo/PZ_3/src/checkpoint.cpp" "CMakeFiles/bigint.dir/src/checkpoint.cpp.o" "gcc" "CMakeFiles/bigint.dir/src/checkpoint.cpp.o.d"
+  "/root/repo/PZ_3/src/montgomery_batch.cpp" "CMakeFiles/bigint.dir/src/montgomery_batch.cpp.o" "gcc" "CMakeFiles/bigint.dir/src/montgomery_batch.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bigint.dir/src/bigint.cpp.o"
+  "CMakeFiles/bigint.dir/src/bigint.cpp.o.d"
+  "CMakeFiles/bigint.dir/src/bigint_gmp.cpp.o"
+  "CMakeFiles/bigint.dir/src/bigint_gmp.cpp.o.d"
+  "CMakeFiles/bigint.dir/src/bigint_stats.cpp.o"
+  "CMakeFiles/bigint.dir/src/bigint_stats.cpp.o.d"
+  "CMakeFiles/bigint.dir/src/checkpoint.cpp.o"
+  "CMakeFiles/bigint.dir/src/checkpoint.cpp.o.d"
+  "CMakeFiles/bigint.dir/src/montgomery_batch.cpp.o"
+  "CMakeFiles/bigint.dir/src/montgomery_batch.cpp.o.d"
+  "libbigint.a"
+  "libbigint.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bigint.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
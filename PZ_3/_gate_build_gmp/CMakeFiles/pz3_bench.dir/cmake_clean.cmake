@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pz3_bench.dir/main/bench_arithmetic.cpp.o"
+  "CMakeFiles/pz3_bench.dir/main/bench_arithmetic.cpp.o.d"
+  "pz3_bench"
+  "pz3_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pz3_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/primtest.dir/src/primality_tests.cpp.o"
+  "CMakeFiles/primtest.dir/src/primality_tests.cpp.o.d"
+  "libprimtest.a"
+  "libprimtest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/primtest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/PZ_3/main/main_practical3.cpp" "CMakeFiles/pz3.dir/main/main_practical3.cpp.o" "gcc" "CMakeFiles/pz3.dir/main/main_practical3.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/PZ_3/_gate_build_native/CMakeFiles/bigint.dir/DependInfo.cmake"
+  "/root/repo/PZ_3/_gate_build_native/CMakeFiles/primtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
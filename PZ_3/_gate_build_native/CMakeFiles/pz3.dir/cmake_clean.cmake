@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pz3.dir/main/main_practical3.cpp.o"
+  "CMakeFiles/pz3.dir/main/main_practical3.cpp.o.d"
+  "pz3"
+  "pz3.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pz3.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
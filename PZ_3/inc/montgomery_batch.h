@@ -0,0 +1,41 @@
+#ifndef MONTGOMERY_BATCH_H
+#define MONTGOMERY_BATCH_H
+
+#include "montgomery_lanes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Многодорожечное модульное возведение в степень по Монтгомери
+ *
+ * Независимые возведения с модулями одной длины идут группами по LANES:
+ * лимбы всех дорожек хранятся вперемешку (лимб j дорожки l - элемент
+ * j * LANES + l), поэтому внутренний цикл умножения Монтгомери проходит
+ * по дорожкам одинаковыми операциями и векторизуется компилятором
+ * (64-битные произведения 32-битных лимбов: pmuludq / vpmuludq).
+ * Показатели обрабатываются общими окнами по 4 бита; у более коротких
+ * показателей старшие окна нулевые.
+ *
+ * Ядро не зависит от BigInt: числа передаются массивами 32-битных лимбов
+ * (младший лимб первым). Само умножение в дорожках - MontgomeryLanes
+ * из common/montgomery_lanes.h, общее с RSA.
+ */
+class MontgomeryBatch {
+public:
+    typedef MontgomeryLanes::Limbs Limbs;
+
+    static const int LANES = MontgomeryLanes::LANES;
+    static const int WINDOW_BITS = MontgomeryLanes::WINDOW_BITS;
+
+    /**
+     * results[i] = bases[i]^exps[i] mod mods[i]
+     * Требования: mods[i] нечетный и больше 1, bases[i] < mods[i]
+     */
+    static void modPow(const std::vector<Limbs>& bases,
+                       const std::vector<Limbs>& exps,
+                       const std::vector<Limbs>& mods,
+                       std::vector<Limbs>& results);
+};
+
+#endif
@@ -2,31 +2,39 @@
 #define PRIMALITY_TESTS_H
 
 #include "bigint.h"
+#include "checkpoint.h"
 #include <random>
 #include <vector>
 #include <map>
-#include <tuple>  // Добавлено для std::tuple
 
 class PrimalityTests {
 private:
     static std::vector<BigInt> getWitnesses(const BigInt& n, int count);
     static bool isWitness(const BigInt& a, const BigInt& n);
-    
-    // Методы для теста Люка
-    static bool isStrongLucasWitness(const BigInt& n, const BigInt& d, int p, int q);
-    static int jacobiSymbol(const BigInt& a, const BigInt& n);  // Добавлено
-    static std::tuple<BigInt, int, int> findLucasParameters(const BigInt& n);  // Изменено
-    static BigInt lucasSequenceU(const BigInt& k, int p, int q, const BigInt& n);  // Добавлено
-    static BigInt lucasSequenceV(const BigInt& k, int p, int q, const BigInt& n);  // Добавлено
+    // Проверка по x = a^d mod n, где n-1 = d * 2^s
+    static bool isWitnessFrom(BigInt x, const BigInt& n, int s);
+    // Есть ли среди witnesses свидетель составности (a^d mod n - через modPowBatch)
+    static bool hasWitness(const std::vector<BigInt>& witnesses, const BigInt& n);
     
 public:
+    // Пробное деление на простые меньше 10000 за одно длинное деление
+    // (n mod P, P - произведение этих простых); остальное - в машинных словах.
+    // Возвращает наименьший простой делитель |n| из этого диапазона или 0
+    static int smallPrimeFactor(const BigInt& n);
+    
     // 1. Тест Миллера-Рабина
     static bool millerRabinTest(const BigInt& n, int iterations = 10);
     static void millerRabinStatistics(const BigInt& n, int tests_count = 100);
     
-    // 2. Тест Люка на сильную псевдопростоту
+    // 2. Тест Люка на сильную псевдопростоту: пробное деление, затем
+    // BigInt::isStrongLucasProbablePrime (параметры Селфриджа, лестница U, V)
     static bool lucasStrongTest(const BigInt& n, int iterations = 10);
     static void lucasStrongStatistics(const BigInt& n, int tests_count = 100);
+
+    // Тест Люка с контрольными точками в лестнице U, V (файлы path.*)
+    static bool lucasStrongTest(const BigInt& n, const CheckpointConfig& checkpoint);
+    // Продолжение теста Люка с последней корректной контрольной точки
+    static bool resumeLucasStrongTest(const CheckpointConfig& checkpoint);
     
     // 3. Тест Бейли-Померанца-Селфриджа-Уогстаффа (BPSW)
     static bool bpswTest(const BigInt& n, int iterations = 10);
@@ -35,6 +43,23 @@ public:
     // 4. Сравнение всех тестов
     static void compareAllTests(const BigInt& n, int tests_count = 100);
     
+    // 5. Миллер-Рабин с числом раундов по длине числа и допустимой ошибке
+    // Наименьшее число раундов со случайными основаниями, после которых случайное
+    // нечетное bits-битное число составное с вероятностью не более 2^-error_bits
+    // (средние оценки Дамгорда-Ландрока-Померанса, как в таблицах FIPS 186)
+    static int millerRabinRounds(int bits, int error_bits = 100);
+    // millerRabinTest на millerRabinRounds(n.bitLength(), error_bits) раундов;
+    // with_lucas - дополнительно сильный тест Люка
+    static bool probablePrimeTest(const BigInt& n, int error_bits = 100, bool with_lucas = false);
+    
+    // 6. Пакетная проверка простоты; результаты в порядке входа.
+    // Все числа просеиваются вместе по простым меньше sieve_limit деревом
+    // произведений и деревом остатков (Бернштейн): P mod n_i для всех i, где
+    // P - произведение простых, затем gcd(P mod n_i, n_i). Оставшиеся числа
+    // проверяет BPSW в threads потоках (0 - по числу ядер)
+    static std::vector<bool> isPrimeBatch(const std::vector<BigInt>& numbers, unsigned threads = 0,
+                                          int sieve_limit = 1 << 18);
+    
     // Вспомогательные методы
     static std::vector<BigInt> generateTestNumbers(int min_digits, int max_digits, int count);
     static void runComprehensiveAnalysis();
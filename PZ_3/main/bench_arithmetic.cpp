@@ -0,0 +1,503 @@
+// Микробенчмарк арифметики BigInt с эталоном GMP (mpz_class)
+//
+// Сборка: цель pz3_bench в CMakeLists.txt
+//   cmake -S . -B build && cmake --build build --target pz3_bench
+//
+// Запуск:
+//   ./pz3_bench                                  - полный прогон, таблица в консоль
+//   ./pz3_bench --out results.json               - сохранить результаты в JSON
+//   ./pz3_bench --compare baseline.json          - сравнить с сохраненным прогоном
+//   ./pz3_bench --ops mul,divmod --max-digits 100000 --budget 0.5
+//
+// Для каждой операции размеры перебираются от 64 бит до 10^7 цифр. Время
+// следующего размера оценивается по асимптотике операции; если оценка
+// превышает --budget секунд на одну операцию, большие размеры пропускаются.
+
+#include "bigint.h"
+#include <gmpxx.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <cstring>
+
+using namespace std;
+
+// ==================== ПАРАМЕТРЫ ПРОГОНА ====================
+
+struct BenchOptions {
+    string outPath;
+    string comparePath;
+    vector<string> ops;
+    long long maxDigits = 10000000;
+    double minTime = 0.1;     // минимальное время замера одной точки, с
+    double budget = 1.0;      // предельное время одной операции, с
+    double threshold = 0.10;  // допустимое замедление относительно эталона
+    bool relative = false;    // сравнивать отношение к GMP, а не абсолютное время
+};
+
+struct BenchSize {
+    const char* label;
+    long long digits;
+};
+
+// 64..4096 бит переведены в десятичные цифры (ceil(bits * log10(2)))
+const BenchSize BENCH_SIZES[] = {
+    {"64b", 20}, {"128b", 39}, {"256b", 78}, {"512b", 155}, {"1024b", 309},
+    {"2048b", 617}, {"4096b", 1234}, {"1e4d", 10000}, {"1e5d", 100000},
+    {"1e6d", 1000000}, {"1e7d", 10000000},
+};
+
+struct BenchResult {
+    string op;
+    string label;
+    long long digits = 0;
+    long long iterations = 0;
+    double nsPerOp = -1;       // -1 - точка пропущена
+    long long gmpIterations = 0;
+    double gmpNsPerOp = -1;
+};
+
+// ==================== ЗАМЕР ====================
+
+// Результат операции, чтобы компилятор не удалил вычисления
+volatile long long benchSink = 0;
+
+/**
+ * Повторяет операцию, пока суммарное время не превысит minTime
+ * @return время одной операции в наносекундах
+ */
+double measure(const function<void()>& op, double minTime, long long& iterations) {
+    using clock = chrono::steady_clock;
+
+    auto start = clock::now();
+    op();
+    double first = chrono::duration<double>(clock::now() - start).count();
+    if (first >= minTime) {
+        iterations = 1;
+        return first * 1e9;
+    }
+
+    long long batch = max(1LL, static_cast<long long>(minTime / max(first, 1e-9) / 4));
+    long long total = 0;
+    double elapsed = 0;
+    while (elapsed < minTime) {
+        start = clock::now();
+        for (long long i = 0; i < batch; ++i) op();
+        elapsed += chrono::duration<double>(clock::now() - start).count();
+        total += batch;
+        batch *= 2;
+    }
+    iterations = total;
+    return elapsed / total * 1e9;
+}
+
+/**
+ * Операнды одного размера для обоих ядер
+ * a, b, m - по digits цифр; wide - 2*digits цифр (делимое, подкоренное)
+ */
+struct BenchOperands {
+    BigInt a, b, m, wide;
+    string text;
+    mpz_class ga, gb, gm, gwide;
+    bool hasBigInt = false;
+    bool hasGmp = false;
+};
+
+void prepareOperands(BenchOperands& x, long long digits, bool needBigInt, bool needGmp) {
+    // Одинаковые значения при каждом запуске - результаты сравнимы между прогонами
+    mt19937 gen(static_cast<unsigned>(digits));
+    BigInt a(static_cast<int>(digits), gen);
+    BigInt b(static_cast<int>(digits), gen);
+    BigInt m(static_cast<int>(digits), gen);
+    BigInt wide(static_cast<int>(2 * digits), gen);
+    x.text = a.toString();
+
+    if (needGmp) {
+        x.ga.set_str(x.text, 10);
+        x.gb.set_str(b.toString(), 10);
+        x.gm.set_str(m.toString(), 10);
+        x.gwide.set_str(wide.toString(), 10);
+        x.hasGmp = true;
+    }
+    if (needBigInt) {
+        x.a = a;
+        x.b = b;
+        x.m = m;
+        x.wide = wide;
+        x.hasBigInt = true;
+    }
+}
+
+/**
+ * Описание операции: реализация на BigInt, реализация на GMP и степень
+ * роста времени от числа цифр (для отсечения неподъемных размеров)
+ */
+struct BenchOp {
+    const char* name;
+    double growth;
+    function<void(BenchOperands&)> bigint;
+    function<void(BenchOperands&)> gmp;
+};
+
+vector<BenchOp> makeOps() {
+    vector<BenchOp> ops;
+
+    ops.push_back({"add", 1.0,
+        [](BenchOperands& x) { benchSink += (x.a + x.b).getLastDigit(); },
+        [](BenchOperands& x) { mpz_class r = x.ga + x.gb; benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10); }});
+
+    ops.push_back({"mul", 2.0,
+        [](BenchOperands& x) { benchSink += (x.a * x.b).getLastDigit(); },
+        [](BenchOperands& x) { mpz_class r = x.ga * x.gb; benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10); }});
+
+    ops.push_back({"sqr", 2.0,
+        [](BenchOperands& x) { benchSink += (x.a * x.a).getLastDigit(); },
+        [](BenchOperands& x) { mpz_class r = x.ga * x.ga; benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10); }});
+
+    ops.push_back({"divmod", 2.0,
+        [](BenchOperands& x) {
+            BigInt q = x.wide / x.b;
+            BigInt r = x.wide % x.b;
+            benchSink += q.getLastDigit() + r.getLastDigit();
+        },
+        [](BenchOperands& x) {
+            mpz_class q, r;
+            mpz_tdiv_qr(q.get_mpz_t(), r.get_mpz_t(), x.gwide.get_mpz_t(), x.gb.get_mpz_t());
+            benchSink += mpz_tdiv_ui(q.get_mpz_t(), 10) + mpz_tdiv_ui(r.get_mpz_t(), 10);
+        }});
+
+    ops.push_back({"modPow", 3.0,
+        [](BenchOperands& x) { benchSink += BigInt::modPow(x.a, x.b, x.m).getLastDigit(); },
+        [](BenchOperands& x) {
+            mpz_class r;
+            mpz_powm(r.get_mpz_t(), x.ga.get_mpz_t(), x.gb.get_mpz_t(), x.gm.get_mpz_t());
+            benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10);
+        }});
+
+    ops.push_back({"gcd", 3.0,
+        [](BenchOperands& x) { benchSink += BigInt::gcd(x.a, x.b).getLastDigit(); },
+        [](BenchOperands& x) {
+            mpz_class r;
+            mpz_gcd(r.get_mpz_t(), x.ga.get_mpz_t(), x.gb.get_mpz_t());
+            benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10);
+        }});
+
+    ops.push_back({"isqrt", 3.0,
+        [](BenchOperands& x) { benchSink += BigInt::sqrt(x.wide).getLastDigit(); },
+        [](BenchOperands& x) {
+            mpz_class r;
+            mpz_sqrt(r.get_mpz_t(), x.gwide.get_mpz_t());
+            benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10);
+        }});
+
+    ops.push_back({"toString", 2.0,
+        [](BenchOperands& x) { benchSink += x.a.toString().size(); },
+        [](BenchOperands& x) { benchSink += x.ga.get_str(10).size(); }});
+
+    ops.push_back({"parse", 2.0,
+        [](BenchOperands& x) { benchSink += BigInt(x.text).getLastDigit(); },
+        [](BenchOperands& x) {
+            mpz_class r;
+            r.set_str(x.text, 10);
+            benchSink += mpz_tdiv_ui(r.get_mpz_t(), 10);
+        }});
+
+    return ops;
+}
+
+/**
+ * Отслеживает, пора ли прекратить рост размеров для одного ядра
+ */
+struct GrowthLimit {
+    double lastSeconds = 0;
+    long long lastDigits = 0;
+    bool stopped = false;
+
+    bool allows(long long digits, double growth, double budget) const {
+        if (stopped) return false;
+        if (lastDigits == 0) return true;
+        double predicted = lastSeconds * pow(static_cast<double>(digits) / lastDigits, growth);
+        return predicted <= budget;
+    }
+
+    void record(long long digits, double seconds, double budget) {
+        lastDigits = digits;
+        lastSeconds = seconds;
+        if (seconds > budget) stopped = true;
+    }
+};
+
+vector<BenchResult> runBenchmarks(const BenchOptions& options) {
+    vector<BenchOp> ops = makeOps();
+    vector<BenchOp> selected;
+    for (const BenchOp& op : ops) {
+        if (options.ops.empty() || find(options.ops.begin(), options.ops.end(), op.name) != options.ops.end()) {
+            selected.push_back(op);
+        }
+    }
+    if (selected.empty()) {
+        throw invalid_argument("No known operations selected");
+    }
+
+    vector<GrowthLimit> bigintLimit(selected.size()), gmpLimit(selected.size());
+    vector<BenchResult> results;
+
+    for (const BenchSize& size : BENCH_SIZES) {
+        if (size.digits > options.maxDigits) break;
+
+        bool needBigInt = false, needGmp = false;
+        for (size_t i = 0; i < selected.size(); ++i) {
+            needBigInt = needBigInt || bigintLimit[i].allows(size.digits, selected[i].growth, options.budget);
+            needGmp = needGmp || gmpLimit[i].allows(size.digits, selected[i].growth, options.budget);
+        }
+        if (!needBigInt && !needGmp) break;
+
+        BenchOperands x;
+        prepareOperands(x, size.digits, needBigInt, needGmp);
+
+        for (size_t i = 0; i < selected.size(); ++i) {
+            const BenchOp& op = selected[i];
+            BenchResult r;
+            r.op = op.name;
+            r.label = size.label;
+            r.digits = size.digits;
+
+            if (bigintLimit[i].allows(size.digits, op.growth, options.budget)) {
+                r.nsPerOp = measure([&]() { op.bigint(x); }, options.minTime, r.iterations);
+                bigintLimit[i].record(size.digits, r.nsPerOp * 1e-9, options.budget);
+            }
+            if (gmpLimit[i].allows(size.digits, op.growth, options.budget)) {
+                r.gmpNsPerOp = measure([&]() { op.gmp(x); }, options.minTime, r.gmpIterations);
+                gmpLimit[i].record(size.digits, r.gmpNsPerOp * 1e-9, options.budget);
+            }
+            if (r.nsPerOp < 0 && r.gmpNsPerOp < 0) continue;
+
+            results.push_back(r);
+            cout << setw(9) << r.op << setw(7) << r.label;
+            if (r.nsPerOp >= 0) {
+                cout << setw(16) << fixed << setprecision(1) << r.nsPerOp << " ns/op"
+                     << setw(14) << setprecision(3) << r.digits * 1e3 / r.nsPerOp << " Mdig/s";
+            } else {
+                cout << setw(22) << "skipped" << setw(21) << " ";
+            }
+            if (r.gmpNsPerOp >= 0) {
+                cout << "   gmp " << setw(14) << setprecision(1) << r.gmpNsPerOp << " ns/op";
+                if (r.nsPerOp >= 0) {
+                    cout << "   x" << setprecision(2) << r.nsPerOp / r.gmpNsPerOp;
+                }
+            } else {
+                cout << "   gmp skipped";
+            }
+            cout << endl;
+        }
+    }
+    return results;
+}
+
+// ==================== JSON ====================
+
+string jsonNumber(double value, int precision) {
+    if (value < 0) return "null";
+    ostringstream out;
+    out << fixed << setprecision(precision) << value;
+    return out.str();
+}
+
+void writeJson(const string& path, const vector<BenchResult>& results) {
+    ofstream fout(path);
+    if (!fout) {
+        throw runtime_error("Cannot write results: " + path);
+    }
+
+    fout << "{\n";
+    fout << "  \"backend\": \"" << BigInt::backendName() << "\",\n";
+    fout << "  \"gmp_version\": \"" << gmp_version << "\",\n";
+    fout << "  \"results\": [\n";
+    // Каждая запись на отдельной строке - так ее читает режим --compare
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        double ratio = (r.nsPerOp >= 0 && r.gmpNsPerOp > 0) ? r.nsPerOp / r.gmpNsPerOp : -1;
+        fout << "    {\"op\": \"" << r.op << "\", \"size\": \"" << r.label << "\", \"digits\": " << r.digits
+             << ", \"iterations\": " << r.iterations
+             << ", \"ns_per_op\": " << jsonNumber(r.nsPerOp, 1)
+             << ", \"ops_per_sec\": " << jsonNumber(r.nsPerOp > 0 ? 1e9 / r.nsPerOp : -1, 3)
+             << ", \"mdigits_per_sec\": " << jsonNumber(r.nsPerOp > 0 ? r.digits * 1e3 / r.nsPerOp : -1, 3)
+             << ", \"gmp_iterations\": " << r.gmpIterations
+             << ", \"gmp_ns_per_op\": " << jsonNumber(r.gmpNsPerOp, 1)
+             << ", \"ratio_vs_gmp\": " << jsonNumber(ratio, 3) << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    fout << "  ]\n";
+    fout << "}\n";
+}
+
+// Значение поля "key": из строки записи (null и отсутствие поля - false)
+bool jsonField(const string& line, const string& key, string& value) {
+    string pattern = "\"" + key + "\":";
+    size_t pos = line.find(pattern);
+    if (pos == string::npos) return false;
+    pos = line.find_first_not_of(' ', pos + pattern.size());
+    if (pos == string::npos) return false;
+
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        if (end == string::npos) return false;
+        value = line.substr(pos + 1, end - pos - 1);
+        return true;
+    }
+    size_t end = line.find_first_of(",}", pos);
+    value = line.substr(pos, end - pos);
+    return value != "null";
+}
+
+/**
+ * Читает результаты, сохраненные writeJson
+ */
+vector<BenchResult> readJson(const string& path) {
+    ifstream fin(path);
+    if (!fin) {
+        throw runtime_error("Cannot open baseline: " + path);
+    }
+
+    vector<BenchResult> results;
+    string line, value;
+    while (getline(fin, line)) {
+        BenchResult r;
+        if (!jsonField(line, "op", r.op)) continue;
+        jsonField(line, "size", r.label);
+        if (jsonField(line, "digits", value)) r.digits = stoll(value);
+        if (jsonField(line, "ns_per_op", value)) r.nsPerOp = stod(value);
+        if (jsonField(line, "gmp_ns_per_op", value)) r.gmpNsPerOp = stod(value);
+        results.push_back(r);
+    }
+    return results;
+}
+
+/**
+ * Сравнивает текущий прогон с эталонным
+ * @return количество замедлений больше порога
+ */
+int compareWithBaseline(const vector<BenchResult>& current, const vector<BenchResult>& baseline,
+                        const BenchOptions& options) {
+    cout << "\n==========================================" << endl;
+    cout << "СРАВНЕНИЕ С ЭТАЛОНОМ (" << (options.relative ? "отношение к GMP" : "время операции")
+         << ", порог " << setprecision(0) << fixed << options.threshold * 100 << "%)" << endl;
+    cout << "==========================================" << endl;
+
+    int regressions = 0;
+    for (const BenchResult& cur : current) {
+        for (const BenchResult& base : baseline) {
+            if (base.op != cur.op || base.digits != cur.digits) continue;
+            if (cur.nsPerOp < 0 || base.nsPerOp < 0) break;
+
+            double now = cur.nsPerOp, before = base.nsPerOp;
+            if (options.relative) {
+                if (cur.gmpNsPerOp <= 0 || base.gmpNsPerOp <= 0) break;
+                now /= cur.gmpNsPerOp;
+                before /= base.gmpNsPerOp;
+            }
+
+            double change = now / before - 1.0;
+            bool slower = change > options.threshold;
+            if (slower) regressions++;
+
+            cout << setw(9) << cur.op << setw(7) << cur.label
+                 << setw(9) << showpos << setprecision(1) << change * 100 << "%" << noshowpos
+                 << (slower ? "   SLOWDOWN" : "") << endl;
+            break;
+        }
+    }
+
+    cout << "Замедлений: " << regressions << endl;
+    return regressions;
+}
+
+// ==================== КОМАНДНАЯ СТРОКА ====================
+
+void printUsage(const char* program) {
+    cout << "Использование: " << program << " [параметры]\n"
+         << "  --out FILE          сохранить результаты в JSON\n"
+         << "  --compare FILE      сравнить с эталоном, код возврата 2 при замедлении\n"
+         << "  --threshold X       допустимое замедление (по умолчанию 0.10 = 10%)\n"
+         << "  --relative          сравнивать отношение к GMP (меньше зависит от машины)\n"
+         << "  --ops a,b,...       операции: add,mul,sqr,divmod,modPow,gcd,isqrt,toString,parse\n"
+         << "  --max-digits N      наибольший размер операндов (по умолчанию 10000000)\n"
+         << "  --min-time S        минимальное время замера точки (по умолчанию 0.1 с)\n"
+         << "  --budget S          предельное время одной операции (по умолчанию 1 с)\n";
+}
+
+vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+BenchOptions parseOptions(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--relative") {
+            options.relative = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw invalid_argument("Missing value for " + arg);
+        }
+        string value = argv[++i];
+        if (arg == "--out") options.outPath = value;
+        else if (arg == "--compare") options.comparePath = value;
+        else if (arg == "--threshold") options.threshold = stod(value);
+        else if (arg == "--ops") options.ops = splitList(value);
+        else if (arg == "--max-digits") options.maxDigits = stoll(value);
+        else if (arg == "--min-time") options.minTime = stod(value);
+        else if (arg == "--budget") options.budget = stod(value);
+        else throw invalid_argument("Unknown option " + arg);
+    }
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    cout << "==========================================" << endl;
+    cout << "БЕНЧМАРК АРИФМЕТИКИ BigInt (ядро " << BigInt::backendName()
+         << ", эталон GMP " << gmp_version << ")" << endl;
+    cout << "==========================================" << endl;
+
+    try {
+        vector<BenchResult> results = runBenchmarks(options);
+
+        if (!options.outPath.empty()) {
+            writeJson(options.outPath, results);
+            cout << "\nРезультаты сохранены в " << options.outPath << endl;
+        }
+        if (!options.comparePath.empty()) {
+            vector<BenchResult> baseline = readJson(options.comparePath);
+            if (compareWithBaseline(results, baseline, options) > 0) {
+                return 2;
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -88,6 +88,34 @@ void verifyWithGMP() {
     }
 }
 
+void demonstrateAdaptiveRounds() {
+    cout << "==========================================" << endl;
+    cout << "ЧИСЛО РАУНДОВ МИЛЛЕРА-РАБИНА (ОШИБКА 2^-100)" << endl;
+    cout << "==========================================" << endl;
+    
+    for (int bits : {64, 256, 512, 1024, 2048, 4096}) {
+        cout << "  " << setw(5) << bits << " бит: "
+             << PrimalityTests::millerRabinRounds(bits, 100) << " раундов" << endl;
+    }
+    
+    // Простое Мерсенна 2^521 - 1 и составное (2^89 - 1)(2^107 - 1)
+    auto mersenne = [](int p) {
+        BigInt m(1);
+        for (int i = 0; i < p; ++i) m = m * BigInt(2);
+        return m - BigInt(1);
+    };
+    BigInt prime = mersenne(521);
+    BigInt composite = mersenne(89) * mersenne(107);
+    for (const BigInt* n : {&prime, &composite}) {
+        auto start = chrono::high_resolution_clock::now();
+        bool result = PrimalityTests::probablePrimeTest(*n, 100, true);
+        auto end = chrono::high_resolution_clock::now();
+        cout << "  " << n->bitLength() << " бит: " << (result ? "простое" : "составное")
+             << " (" << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " мс)" << endl;
+    }
+    cout << endl;
+}
+
 int main() {
     setlocale(LC_ALL, "ru");
     
@@ -101,6 +129,9 @@ int main() {
         // Проверка с GMP
         verifyWithGMP();
         
+        // Адаптивное число раундов
+        demonstrateAdaptiveRounds();
+        
         // Комплексный анализ
         PrimalityTests::runComprehensiveAnalysis();
         
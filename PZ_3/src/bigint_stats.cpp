@@ -0,0 +1,181 @@
+#include "bigint_stats.h"
+#include <iomanip>
+
+#ifdef BIGINT_STATS
+#include <atomic>
+#endif
+
+using namespace std;
+
+// ==================== СНИМОК ====================
+
+namespace {
+
+// Границы корзин в десятичных цифрах: 64, 128, 256, 512, 1024, 2048, 4096 бит
+const size_t BUCKET_LIMITS[BigIntStatsSnapshot::BUCKET_COUNT - 1] = {20, 39, 78, 155, 309, 617, 1234};
+
+const char* const OPERATION_NAMES[BigIntStatsSnapshot::OPERATION_COUNT] = {
+    "add", "sub", "mul", "div", "mod", "pow", "modPow", "gcd", "sqrt"
+};
+
+} // namespace
+
+BigIntStatsSnapshot::BigIntStatsSnapshot() : allocations(0), allocatedBytes(0), temporaries(0) {
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        for (int b = 0; b < BUCKET_COUNT; ++b) {
+            operations[op][b] = 0;
+        }
+    }
+}
+
+uint64_t BigIntStatsSnapshot::total(Operation op) const {
+    uint64_t sum = 0;
+    for (int b = 0; b < BUCKET_COUNT; ++b) {
+        sum += operations[op][b];
+    }
+    return sum;
+}
+
+const char* BigIntStatsSnapshot::operationName(Operation op) {
+    return OPERATION_NAMES[op];
+}
+
+size_t BigIntStatsSnapshot::bucketLimit(int bucket) {
+    return bucket < BUCKET_COUNT - 1 ? BUCKET_LIMITS[bucket] : 0;
+}
+
+int BigIntStatsSnapshot::bucketFor(size_t digits) {
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && digits > BUCKET_LIMITS[bucket]) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+// ==================== СЧЕТЧИКИ ====================
+
+#ifdef BIGINT_STATS
+
+namespace {
+
+atomic<uint64_t> operationCounters[BigIntStatsSnapshot::OPERATION_COUNT][BigIntStatsSnapshot::BUCKET_COUNT];
+atomic<uint64_t> allocationCounter(0);
+atomic<uint64_t> allocatedBytesCounter(0);
+atomic<uint64_t> temporaryCounter(0);
+
+// Глубина вложенности учитываемых операций в текущем потоке
+thread_local int operationDepth = 0;
+
+} // namespace
+
+bool BigIntStats::enabled() {
+    return true;
+}
+
+BigIntStatsSnapshot BigIntStats::snapshot() {
+    BigIntStatsSnapshot stats;
+    for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op) {
+        for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b) {
+            stats.operations[op][b] = operationCounters[op][b].load(memory_order_relaxed);
+        }
+    }
+    stats.allocations = allocationCounter.load(memory_order_relaxed);
+    stats.allocatedBytes = allocatedBytesCounter.load(memory_order_relaxed);
+    stats.temporaries = temporaryCounter.load(memory_order_relaxed);
+    return stats;
+}
+
+void BigIntStats::reset() {
+    for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op) {
+        for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b) {
+            operationCounters[op][b].store(0, memory_order_relaxed);
+        }
+    }
+    allocationCounter.store(0, memory_order_relaxed);
+    allocatedBytesCounter.store(0, memory_order_relaxed);
+    temporaryCounter.store(0, memory_order_relaxed);
+}
+
+void BigIntStats::countAllocation(size_t bytes) {
+    allocationCounter.fetch_add(1, memory_order_relaxed);
+    allocatedBytesCounter.fetch_add(bytes, memory_order_relaxed);
+}
+
+void BigIntStats::countTemporary() {
+    temporaryCounter.fetch_add(1, memory_order_relaxed);
+}
+
+BigIntStats::Scope::Scope(BigIntStatsSnapshot::Operation op, size_t digits)
+    : outer(operationDepth == 0) {
+    if (outer) {
+        operationCounters[op][BigIntStatsSnapshot::bucketFor(digits)].fetch_add(1, memory_order_relaxed);
+    }
+    ++operationDepth;
+}
+
+BigIntStats::Scope::~Scope() {
+    --operationDepth;
+}
+
+#else
+
+bool BigIntStats::enabled() {
+    return false;
+}
+
+BigIntStatsSnapshot BigIntStats::snapshot() {
+    return BigIntStatsSnapshot();
+}
+
+void BigIntStats::reset() {}
+
+void BigIntStats::countAllocation(size_t) {}
+
+void BigIntStats::countTemporary() {}
+
+BigIntStats::Scope::Scope(BigIntStatsSnapshot::Operation, size_t) : outer(false) {}
+
+BigIntStats::Scope::~Scope() {}
+
+#endif
+
+// ==================== ВЫВОД ====================
+
+void BigIntStats::print(ostream& os, const BigIntStatsSnapshot& stats) {
+    os << "------------------------------------------" << endl;
+    os << "СЧЕТЧИКИ ОПЕРАЦИЙ BigInt" << endl;
+    os << "------------------------------------------" << endl;
+    if (!enabled()) {
+        os << "Счетчики отключены (сборка без BIGINT_STATS)" << endl;
+        return;
+    }
+
+    // Заголовок: верхние границы корзин в цифрах
+    os << setw(8) << " ";
+    for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b) {
+        size_t limit = BigIntStatsSnapshot::bucketLimit(b);
+        string label = limit ? "<=" + to_string(limit) : ">" + to_string(BigIntStatsSnapshot::bucketLimit(b - 1));
+        os << setw(11) << label;
+    }
+    os << setw(12) << "total" << endl;
+
+    for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op) {
+        BigIntStatsSnapshot::Operation operation = static_cast<BigIntStatsSnapshot::Operation>(op);
+        uint64_t total = stats.total(operation);
+        if (total == 0) continue;
+
+        os << setw(8) << BigIntStatsSnapshot::operationName(operation);
+        for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b) {
+            os << setw(11) << stats.operations[op][b];
+        }
+        os << setw(12) << total << endl;
+    }
+
+    os << "Выделений памяти: " << stats.allocations
+       << " (" << stats.allocatedBytes << " байт)" << endl;
+    os << "Созданных объектов BigInt: " << stats.temporaries << endl;
+}
+
+void BigIntStats::print(ostream& os) {
+    print(os, snapshot());
+}
@@ -0,0 +1,235 @@
+#include "checkpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+// ==================== ДВОИЧНОЕ КОДИРОВАНИЕ ====================
+
+namespace {
+
+const char CHECKPOINT_MAGIC[4] = {'B', 'I', 'C', 'K'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+void putU32(string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+void putU64(string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+void putBytes(string& out, const string& bytes) {
+    putU32(out, static_cast<uint32_t>(bytes.size()));
+    out += bytes;
+}
+
+// Контрольная сумма FNV-1a (64 бита)
+uint64_t fnv1a(const string& data, size_t length) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Последовательное чтение с проверкой границ
+class Reader {
+    const string& data;
+    size_t pos;
+    size_t end;
+
+public:
+    Reader(const string& data, size_t end) : data(data), pos(0), end(end) {}
+
+    bool u32(uint32_t& v) {
+        if (end - pos < 4) return false;
+        v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+        pos += 4;
+        return true;
+    }
+
+    bool u64(uint64_t& v) {
+        if (end - pos < 8) return false;
+        v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+        pos += 8;
+        return true;
+    }
+
+    bool bytes(string& out) {
+        uint32_t len;
+        if (!u32(len) || end - pos < len) return false;
+        out.assign(data, pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool raw(char* out, size_t len) {
+        if (end - pos < len) return false;
+        data.copy(out, len, pos);
+        pos += len;
+        return true;
+    }
+
+    bool done() const { return pos == end; }
+};
+
+string encodeState(const CheckpointState& state) {
+    string out(CHECKPOINT_MAGIC, 4);
+    putU32(out, CHECKPOINT_VERSION);
+    putU64(out, state.sequence);
+    putBytes(out, state.task);
+    putBytes(out, state.key);
+    putU64(out, static_cast<uint64_t>(state.iteration));
+    putU32(out, static_cast<uint32_t>(state.residues.size()));
+    for (const BigInt& r : state.residues) {
+        out.push_back(r.sign() < 0 ? 1 : 0);
+        putBytes(out, r.abs().toString());
+    }
+    putU64(out, fnv1a(out, out.size()));
+    return out;
+}
+
+bool decodeState(const string& data, CheckpointState& state) {
+    if (data.size() < 4 + 8) return false;
+
+    size_t body = data.size() - 8;
+    uint64_t stored = 0;
+    for (int i = 0; i < 8; ++i) {
+        stored |= static_cast<uint64_t>(static_cast<unsigned char>(data[body + i])) << (8 * i);
+    }
+    if (stored != fnv1a(data, body)) return false;
+
+    Reader in(data, body);
+    char magic[4];
+    uint32_t version, count;
+    uint64_t iteration;
+    if (!in.raw(magic, 4) || !equal(magic, magic + 4, CHECKPOINT_MAGIC)) return false;
+    if (!in.u32(version) || version != CHECKPOINT_VERSION) return false;
+    if (!in.u64(state.sequence) || !in.bytes(state.task) || !in.bytes(state.key)) return false;
+    if (!in.u64(iteration) || !in.u32(count)) return false;
+    state.iteration = static_cast<long long>(iteration);
+
+    state.residues.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        char negative;
+        string magnitude;
+        if (!in.raw(&negative, 1) || !in.bytes(magnitude)) return false;
+        try {
+            BigInt value(magnitude);
+            state.residues.push_back(negative ? -value : value);
+        } catch (const exception&) {
+            return false;
+        }
+    }
+    return in.done();
+}
+
+bool readFile(const string& path, string& data) {
+    ifstream fin(path, ios::binary);
+    if (!fin) return false;
+    data.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+// ==================== Checkpointer ====================
+
+Checkpointer::Checkpointer(const CheckpointConfig& config, const string& task, const string& key)
+    : config(config), task(task), key(key), sequence(0), lastIteration(0),
+      lastSave(chrono::steady_clock::now()) {}
+
+string Checkpointer::slotPath(int slot) const {
+    return config.path + "." + to_string(slot);
+}
+
+bool Checkpointer::resume(CheckpointState& state) {
+    if (!config.enabled() || !config.resume) return false;
+
+    CheckpointState loaded;
+    if (!loadLatest(config.path, loaded)) return false;
+    if (loaded.task != task || loaded.key != key) return false;
+
+    sequence = loaded.sequence;
+    lastIteration = loaded.iteration;
+    lastSave = chrono::steady_clock::now();
+    state = loaded;
+    return true;
+}
+
+bool Checkpointer::due(long long iteration) const {
+    if (!config.enabled()) return false;
+    if (config.everyIterations > 0 && iteration - lastIteration >= config.everyIterations) {
+        return true;
+    }
+    if (config.everySeconds > 0) {
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - lastSave;
+        return elapsed.count() >= config.everySeconds;
+    }
+    return false;
+}
+
+void Checkpointer::save(long long iteration, const vector<BigInt>& residues) {
+    if (!config.enabled()) return;
+
+    CheckpointState state;
+    state.task = task;
+    state.key = key;
+    state.iteration = iteration;
+    state.residues = residues;
+    state.sequence = ++sequence;
+
+    string data = encodeState(state);
+    string target = slotPath(static_cast<int>(state.sequence % 2));
+    string tmp = target + ".tmp";
+    {
+        ofstream fout(tmp, ios::binary | ios::trunc);
+        if (!fout) {
+            throw runtime_error("Cannot write checkpoint: " + tmp);
+        }
+        fout.write(data.data(), data.size());
+        if (!fout) {
+            throw runtime_error("Cannot write checkpoint: " + tmp);
+        }
+    }
+    if (rename(tmp.c_str(), target.c_str()) != 0) {
+        throw runtime_error("Cannot replace checkpoint: " + target);
+    }
+
+    lastIteration = iteration;
+    lastSave = chrono::steady_clock::now();
+}
+
+void Checkpointer::finish() {
+    if (config.enabled() && config.removeOnFinish) {
+        remove(config.path);
+    }
+}
+
+bool Checkpointer::loadLatest(const string& path, CheckpointState& state) {
+    bool found = false;
+    for (int slot = 0; slot < 2; ++slot) {
+        string data;
+        CheckpointState candidate;
+        if (!readFile(path + "." + to_string(slot), data)) continue;
+        if (!decodeState(data, candidate)) continue;
+        if (!found || candidate.sequence > state.sequence) {
+            state = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Checkpointer::remove(const string& path) {
+    for (int slot = 0; slot < 2; ++slot) {
+        string file = path + "." + to_string(slot);
+        std::remove(file.c_str());
+        std::remove((file + ".tmp").c_str());
+    }
+}
@@ -0,0 +1,56 @@
+#include "montgomery_batch.h"
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+
+// Группы по L дорожек считает общее ядро MontgomeryLanes (common/montgomery_lanes.h)
+
+namespace {
+
+const int L = MontgomeryBatch::LANES;
+
+}  // namespace
+
+void MontgomeryBatch::modPow(const vector<Limbs>& bases,
+                             const vector<Limbs>& exps,
+                             const vector<Limbs>& mods,
+                             vector<Limbs>& results) {
+    if (bases.size() != mods.size() || exps.size() != mods.size()) {
+        throw invalid_argument("modPowBatch: operand counts differ");
+    }
+
+    // Группы по длине модуля, внутри группы - по L дорожек
+    map<size_t, vector<size_t> > groups;
+    for (size_t i = 0; i < mods.size(); ++i) {
+        size_t size = MontgomeryLanes::significantLimbs(mods[i]);
+        if (size == 0 || (mods[i][0] & 1) == 0 || (size == 1 && mods[i][0] == 1)) {
+            throw invalid_argument("modPowBatch: modulus must be odd and greater than 1");
+        }
+        if (MontgomeryLanes::significantLimbs(bases[i]) > size) {
+            throw invalid_argument("modPowBatch: base must be reduced modulo mod");
+        }
+        groups[size].push_back(i);
+    }
+
+    results.assign(mods.size(), Limbs());
+    for (map<size_t, vector<size_t> >::const_iterator g = groups.begin(); g != groups.end(); ++g) {
+        const vector<size_t>& indices = g->second;
+        for (size_t first = 0; first < indices.size(); first += L) {
+            // Неполная группа дополняется копиями первой дорожки
+            const Limbs* laneBases[L];
+            const Limbs* laneExps[L];
+            const Limbs* laneMods[L];
+            for (int l = 0; l < L; ++l) {
+                size_t i = indices[first + l < indices.size() ? first + l : first];
+                laneBases[l] = &bases[i];
+                laneExps[l] = &exps[i];
+                laneMods[l] = &mods[i];
+            }
+            vector<Limbs> laneResults;
+            MontgomeryLanes::modPow(laneBases, laneExps, laneMods, laneResults);
+            for (int l = 0; l < L && first + l < indices.size(); ++l)
+                results[indices[first + l]].swap(laneResults[l]);
+        }
+    }
+}
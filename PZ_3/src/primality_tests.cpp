@@ -1,13 +1,20 @@
 #include "primality_tests.h"
+#include "trace.h"
 #include <gmpxx.h>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <exception>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
 // ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
 
 vector<BigInt> PrimalityTests::getWitnesses(const BigInt& n, int count) {
+    TRACE_SPAN("witnesses", "primality");
     vector<BigInt> witnesses;
     random_device rd;
     mt19937 gen(rd());
@@ -24,23 +31,18 @@ vector<BigInt> PrimalityTests::getWitnesses(const BigInt& n, int count) {
     return witnesses;
 }
 
-bool PrimalityTests::isWitness(const BigInt& a, const BigInt& n) {
-    //[NOTE:] can be removed
-    if (n < BigInt(2)) return false;
-    if (n == BigInt(2)) return true;
-    if (n.getLastDigit() % 2 == 0) return false;  // Исправлено
-    
-    // Записываем n-1 = d * 2^s
+// Записывает n-1 = d * 2^s
+static BigInt splitPowerOfTwo(const BigInt& n, int& s) {
     BigInt d = n - BigInt(1);
-    int s = 0;
+    s = 0;
     while (d.getLastDigit() % 2 == 0) {  // Исправлено
         d = d / BigInt(2);
         s++;
     }
-    
-    // Вычисляем (a^d mod n) = x
-    BigInt x = BigInt::modPow(a, d, n);
-    
+    return d;
+}
+
+bool PrimalityTests::isWitnessFrom(BigInt x, const BigInt& n, int s) {
     //first condition
     if (x == BigInt(1) || x == n - BigInt(1)) {
         return false; // Не свидетель
@@ -57,36 +59,162 @@ bool PrimalityTests::isWitness(const BigInt& a, const BigInt& n) {
     return true; // Свидетель составности
 }
 
+bool PrimalityTests::isWitness(const BigInt& a, const BigInt& n) {
+    //[NOTE:] can be removed
+    if (n < BigInt(2)) return false;
+    if (n == BigInt(2)) return true;
+    if (n.getLastDigit() % 2 == 0) return false;  // Исправлено
+    
+    int s;
+    BigInt d = splitPowerOfTwo(n, s);
+    
+    // Вычисляем (a^d mod n) = x
+    return isWitnessFrom(BigInt::modPow(a, d, n), n, s);
+}
+
+bool PrimalityTests::hasWitness(const vector<BigInt>& witnesses, const BigInt& n) {
+    if (witnesses.empty()) return false;
+    int s;
+    BigInt d = splitPowerOfTwo(n, s);
+    
+    // a^d mod n для всех кандидатов - одним пакетом (общие n и d)
+    vector<BigInt> xs = BigInt::modPowBatch(witnesses,
+                                            vector<BigInt>(witnesses.size(), d),
+                                            vector<BigInt>(witnesses.size(), n));
+    for (const auto& x : xs) {
+        if (isWitnessFrom(x, n, s)) { //Main moment
+            return true; // Найден свидетель составности
+        }
+    }
+    return false;
+}
+
+// ==================== ПРОБНОЕ ДЕЛЕНИЕ ====================
+
+static const int TRIAL_DIVISION_LIMIT = 10000;
+
+// Простые меньше TRIAL_DIVISION_LIMIT, сгруппированные в произведения меньше 2^32
+struct SmallPrimeGroups {
+    vector<uint32_t> primes;
+    vector<uint32_t> products;
+    vector<size_t> ends;   // ends[g] - конец группы g в primes
+    BigInt product;        // произведение всех простых
+    
+    SmallPrimeGroups() : product(1) {
+        vector<bool> composite(TRIAL_DIVISION_LIMIT, false);
+        for (int i = 2; i < TRIAL_DIVISION_LIMIT; ++i) {
+            if (composite[i]) continue;
+            primes.push_back(i);
+            for (int j = i * i; j < TRIAL_DIVISION_LIMIT; j += i) composite[j] = true;
+        }
+        
+        uint64_t group = 1;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            if (group * primes[i] > 0xFFFFFFFFULL) {
+                products.push_back(static_cast<uint32_t>(group));
+                ends.push_back(i);
+                group = 1;
+            }
+            group *= primes[i];
+        }
+        products.push_back(static_cast<uint32_t>(group));
+        ends.push_back(primes.size());
+        
+        for (uint32_t p : products) product = product * BigInt(static_cast<long long>(p));
+    }
+};
+
+int PrimalityTests::smallPrimeFactor(const BigInt& n) {
+    TRACE_SPAN("trialDivision", "primality");
+    static const SmallPrimeGroups groups;
+    
+    // Единственное длинное деление; остаток - блоками по 9 десятичных цифр
+    const string r = (n.abs() % groups.product).toString();
+    vector<uint32_t> chunks;
+    for (size_t pos = 0, len = r.size() % 9 ? r.size() % 9 : 9; pos < r.size(); pos += len, len = 9) {
+        chunks.push_back(static_cast<uint32_t>(stoul(r.substr(pos, len))));
+    }
+    
+    size_t i = 0;
+    for (size_t g = 0; g < groups.products.size(); ++g) {
+        // Схема Горнера по основанию 10^9 в 64-битной арифметике
+        // (все блоки, кроме первого, ровно из 9 цифр)
+        const uint64_t m = groups.products[g];
+        uint64_t rem = chunks[0] % m;
+        for (size_t c = 1; c < chunks.size(); ++c) {
+            rem = (rem * 1000000000ULL + chunks[c]) % m;
+        }
+        for (; i < groups.ends[g]; ++i) {
+            if (rem % groups.primes[i] == 0) return static_cast<int>(groups.primes[i]);
+        }
+    }
+    return 0;
+}
+
 // ==================== 1. ТЕСТ МИЛЛЕРА-РАБИНА ====================
 
 bool PrimalityTests::millerRabinTest(const BigInt& n, int iterations) {
+    TRACE_SPAN("millerRabin", "primality");
     //[NOTE:] can be removed
     if (n < BigInt(2)) return false;
     if (n == BigInt(2)) return true;
     if (n.getLastDigit() % 2 == 0) return false;  // Исправлено
     
-    //[NOTE:] can be removed
-    // Маленькие простые числа для быстрой проверки
-    vector<int> small_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
-    for (int p : small_primes) {
-        if (n == BigInt(p)) return true;
-        if (n % BigInt(p) == BigInt(0)) return false;
-    }
+    // Пробное деление на простые меньше 10000
+    int factor = smallPrimeFactor(n);
+    if (factor != 0) return n == BigInt(factor);
+    // Делителей меньше 10000 нет, значит n < 10000^2 простое
+    if (n < BigInt(static_cast<long long>(TRIAL_DIVISION_LIMIT) * TRIAL_DIVISION_LIMIT)) return true;
     
     //Generate Witnesses in [2;n-2]
     auto witnesses = getWitnesses(n, iterations);
     
     //Check every Witness
-    for (const auto& a : witnesses) {
-        if (isWitness(a, n)) { //Main moment
-            return false; // Найден свидетель составности
-        }
+    return !hasWitness(witnesses, n); // true - вероятно простое
+}
+
+// log2 оценки сверху вероятности того, что случайное нечетное k-битное число,
+// прошедшее t раундов со случайными основаниями, составное
+// (Damgard, Landrock, Pomerance, 1993; k >= 21). Из применимых оценок берется лучшая
+static double millerRabinErrorLog2(double k, int t) {
+    const double log2k = log2(k);
+    double best = 0;
+    if (t == 1) {
+        best = min(best, 2 * log2k + 2 * (2 - std::sqrt(k)));
     }
-    
-    return true; // Вероятно простое
+    if ((t == 2 && k >= 88) || (t >= 3 && t <= k / 9)) {
+        best = min(best, 1.5 * log2k + t - 0.5 * log2(t) + 2 * (2 - std::sqrt(t * k)));
+    }
+    if (t >= k / 9 && t <= k / 4) {
+        double bound = 7.0 / 20 * k * exp2(-5.0 * t) +
+                       1.0 / 7 * pow(k, 3.75) * exp2(-k / 2 - 2.0 * t) +
+                       12 * k * exp2(-k / 4 - 3.0 * t);
+        best = min(best, log2(bound));
+    }
+    if (t >= k / 4) {
+        best = min(best, log2(1.0 / 7) + 3.75 * log2k - k / 2 - 2.0 * t);
+    }
+    return best;
+}
+
+int PrimalityTests::millerRabinRounds(int bits, int error_bits) {
+    // Для любого составного n раунд ошибается с вероятностью не более 1/4
+    const int worst_case = max(1, (error_bits + 1) / 2);
+    if (bits < 21) return worst_case;
+    for (int t = 1; t < worst_case; ++t) {
+        if (millerRabinErrorLog2(bits, t) <= -error_bits) return t;
+    }
+    return worst_case;
+}
+
+bool PrimalityTests::probablePrimeTest(const BigInt& n, int error_bits, bool with_lucas) {
+    TRACE_SPAN("probablePrime", "primality");
+    if (!millerRabinTest(n, millerRabinRounds(n.bitLength(), error_bits))) return false;
+    return !with_lucas || lucasStrongTest(n);
 }
 
 void PrimalityTests::millerRabinStatistics(const BigInt& n, int tests_count) {
+    TRACE_SPAN("millerRabinStatistics", "statistics");
     cout << "    ТЕСТ МИЛЛЕРА-РАБИНА " << endl;
     cout << "Число: " << n.toString() << endl;
     cout << "Количество тестов: " << tests_count << endl;
@@ -123,225 +251,38 @@ void PrimalityTests::millerRabinStatistics(const BigInt& n, int tests_count) {
 
 // ==================== 2. ТЕСТ ЛЮКА НА СИЛЬНУЮ ПСЕВДОПРОСТОТУ ====================
 
-// ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ДЛЯ ТЕСТА ЛЮКА ====================
-
-// Вычисление символа Якоби (a/n)
-int PrimalityTests::jacobiSymbol(const BigInt& a, const BigInt& n) {
-    if (n == BigInt(1)) return 1;
-    if (a == BigInt(0)) return 0;
-    if (a == BigInt(1)) return 1;
-    
-    BigInt a_temp = a % n;
-    BigInt n_temp = n;
-    
-    int result = 1;
-    
-    while (a_temp != BigInt(0)) {
-        // Убираем множители 2
-        while (a_temp % BigInt(2) == BigInt(0)) {
-            a_temp = a_temp / BigInt(2);
-            BigInt mod8 = n_temp % BigInt(8);
-            if (mod8 == BigInt(3) || mod8 == BigInt(5)) {
-                result = -result;
-            }
-        }
-        
-        // Меняем местами по квадратичному закону взаимности
-        BigInt temp = a_temp;
-        a_temp = n_temp;
-        n_temp = temp;
-        
-        if (a_temp % BigInt(4) == BigInt(3) && n_temp % BigInt(4) == BigInt(3)) {
-            result = -result;
-        }
-        
-        a_temp = a_temp % n_temp;
-    }
-    
-    return (n_temp == BigInt(1)) ? result : 0;
+bool PrimalityTests::lucasStrongTest(const BigInt& n, int /*iterations*/) {
+    return lucasStrongTest(n, CheckpointConfig());
 }
 
-// Нахождение параметров для теста Люка (D, P, Q)
-tuple<BigInt, int, int> PrimalityTests::findLucasParameters(const BigInt& n) {
-    //initialize
-    int d_val = 5;
-    int sign = 1;
-    
-    while (true) {
-        BigInt d(sign * d_val);
-        int jacobi = jacobiSymbol(d, n);
-        
-        // Нужен символ Якоби = -1 - it's main condition
-        if (jacobi == -1) {
-            // P = 1, Q = (1 - D) / 4
-            int p = 1;
-            int q = (1 - sign * d_val) / 4;
-            return make_tuple(d, p, q);
-        }
-        
-        // Чередуем последовательность: 5, -7, 9, -11, 13, -15, ...
-        if (sign == 1) {
-            d_val += 2;
-            sign = -1;
-        } else {
-            sign = 1;
-        }
-        
-        // Защита от бесконечного цикла
-        if (d_val > 100) {
-            return make_tuple(BigInt(5), 1, -1); // Возвращаем значения по умолчанию
-        }
-    }
-}
-
-// Вычисление последовательности Люка U_k mod n
-BigInt PrimalityTests::lucasSequenceU(const BigInt& k, int p, int q, const BigInt& n) {
-    if (k == BigInt(0)) return BigInt(0);
-    if (k == BigInt(1)) return BigInt(1);
-    
-    BigInt u_prev2 = BigInt(0); // U_0
-    BigInt u_prev1 = BigInt(1); // U_1
-    BigInt u_current;
-    
-    // Вычисляем по бинарному представлению k
-    int bits = k.bitLength();
-    for (int i = bits - 2; i >= 0; i--) {
-        // Удвоение индекса: U_{2m} = U_m * V_m
-        BigInt u_temp = u_prev1;
-        BigInt v_temp = (u_prev1 * BigInt(p) - BigInt(2) * u_prev2) % n;
-        u_current = (u_prev1 * v_temp) % n;
-        
-        if (u_current < BigInt(0)) u_current = u_current + n;
-        
-        if (k.getBit(i)) {
-            // U_{m+1} = (P * U_m - Q * U_{m-1}) / 2
-            BigInt u_next = (BigInt(p) * u_current - BigInt(q) * u_prev1) % n; //main moment
-            if (u_next % BigInt(2) != BigInt(0)) {
-                u_next = u_next + n; // Делаем четным для деления
-            }
-            u_next = u_next / BigInt(2);
-            
-            u_prev2 = u_current;
-            u_prev1 = u_next;
-        } else {
-            u_prev2 = u_prev1;
-            u_prev1 = u_current;
-        }
-        
-        // Нормализация по модулю
-        if (u_prev1 < BigInt(0)) u_prev1 = u_prev1 + n;
-        if (u_prev2 < BigInt(0)) u_prev2 = u_prev2 + n;
-    }
-    
-    return u_prev1;
-}
-
-// Вычисление последовательности Люка V_k mod n
-BigInt PrimalityTests::lucasSequenceV(const BigInt& k, int p, int q, const BigInt& n) {
-    if (k == BigInt(0)) return BigInt(2);
-    if (k == BigInt(1)) return BigInt(p);
-    
-    BigInt v_prev2 = BigInt(2);  // V_0
-    BigInt v_prev1 = BigInt(p);  // V_1
-    BigInt v_current;
-    
-    int bits = k.bitLength();
-    for (int i = bits - 2; i >= 0; i--) {
-        // Удвоение индекса: V_{2m} = V_m^2 - 2Q^m
-        v_current = (v_prev1 * v_prev1 - BigInt(2)) % n;
-        
-        if (v_current < BigInt(0)) v_current = v_current + n;
-        
-        if (k.getBit(i)) {
-            // V_{m+1} = P * V_m - Q * V_{m-1}
-            BigInt v_next = (BigInt(p) * v_current - BigInt(q) * v_prev1) % n; //main moment
-            if (v_next < BigInt(0)) v_next = v_next + n;
-            
-            v_prev2 = v_current;
-            v_prev1 = v_next;
-        } else {
-            v_prev2 = v_prev1;
-            v_prev1 = v_current;
-        }
-    }
-    
-    return v_prev1;
-}
-
-// ==================== ТЕСТ ЛЮКА НА СИЛЬНУЮ ПСЕВДОПРОСТОТУ ====================
-
-bool PrimalityTests::isStrongLucasWitness(const BigInt& n, const BigInt& d, int p, int q) {
-    // Проверяем, что gcd(Q, n) = 1
-    BigInt gcd_qn = BigInt::gcd(BigInt(q), n);
-    if (gcd_qn != BigInt(1) && gcd_qn != n) {
-        return true; // Найден нетривиальный делитель
-    }
-    
-    // Вычисляем n - (D/n) = n + 1 (так как (D/n) = -1)
-    BigInt m = n + BigInt(1);
-    
-    // Находим представление m = d * 2^s
-    BigInt d_temp = m;
-    int s = 0;
-    while (d_temp % BigInt(2) == BigInt(0)) {
-        d_temp = d_temp / BigInt(2);
-        s++;
-    }
-    
-    BigInt u_d = lucasSequenceU(d_temp, p, q, n);
-    
-    // Проверка 1: U_d ≡ 0 (mod n)
-    if (u_d == BigInt(0)) {
-        return false; // Не свидетель
-    }
-    
-    // Проверка 2: последовательность V_{d*2^r} для r = 0...s-1
-    BigInt v_current = lucasSequenceV(d_temp, p, q, n);
+bool PrimalityTests::lucasStrongTest(const BigInt& n, const CheckpointConfig& checkpoint) {
+    TRACE_SPAN("lucasStrong", "primality");
+    if (n < BigInt(2)) return false;
+    if (n.isEven()) return n == BigInt(2);
     
-    for (int r = 0; r < s; r++) {
-        if (v_current == BigInt(0)) {
-            return false; // Не свидетель
-        }
-        
-        // Переходим к следующей степени: V_{2k} = V_k^2 - 2
-        if (r < s - 1) {
-            v_current = (v_current * v_current - BigInt(2)) % n;
-            if (v_current < BigInt(0)) v_current = v_current + n;
-        }
-    }
+    // Пробное деление на простые меньше 10000: дальше n подходит под
+    // условие общей реализации теста (нет простых делителей меньше 100)
+    int factor = smallPrimeFactor(n);
+    if (factor != 0) return n == BigInt(factor);
     
-    return true; // Свидетель составности
+    // Параметры Селфриджа, лестница U, V и контрольные точки - в BigInt
+    return BigInt::isStrongLucasProbablePrime(n, checkpoint);
 }
 
-bool PrimalityTests::lucasStrongTest(const BigInt& n, int iterations) {
-    if (n < BigInt(2)) return false;
-    if (n == BigInt(2)) return true;
-    if (n % BigInt(2) == BigInt(0)) return false;
-    
-    // Быстрая проверка маленьких простых
-    vector<int> small_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
-    for (int p : small_primes) {
-        if (n == BigInt(p)) return true;
-        if (n % BigInt(p) == BigInt(0)) return false;
+bool PrimalityTests::resumeLucasStrongTest(const CheckpointConfig& checkpoint) {
+    // Модуль n - последнее поле ключа лестницы
+    CheckpointState state;
+    if (!Checkpointer::loadLatest(checkpoint.path, state)) {
+        throw runtime_error("No valid Lucas checkpoint: " + checkpoint.path);
     }
     
-    // Проверяем, является ли n точным квадратом
-    BigInt sqrt_n = BigInt::sqrt(n);
-    if (sqrt_n * sqrt_n == n) {
-        return false;
-    }
-    
-    // Находим параметры для теста Люка
-    auto params = findLucasParameters(n);
-    BigInt d = get<0>(params);
-    int p_val = get<1>(params);  // Переименовано чтобы избежать конфликта
-    int q = get<2>(params);
-    
-    // ОДНОЙ итерации достаточно для детерминированного теста
-    return !isStrongLucasWitness(n, d, p_val, q);
+    CheckpointConfig config = checkpoint;
+    config.resume = true;
+    return lucasStrongTest(BigInt(state.key.substr(state.key.rfind(';') + 1)), config);
 }
 
 void PrimalityTests::lucasStrongStatistics(const BigInt& n, int tests_count) {
+    TRACE_SPAN("lucasStrongStatistics", "statistics");
     cout << "     ТЕСТ ЛЮКА НА СИЛЬНУЮ ПСЕВДОПРОСТОТУ " << endl;
     cout << "Число: " << n.toString() << endl;
     cout << "Количество тестов: " << tests_count << endl;
@@ -374,24 +315,25 @@ void PrimalityTests::lucasStrongStatistics(const BigInt& n, int tests_count) {
     cout << "Общее время: " << total_duration.count() << " мс" << endl;
     cout << "Среднее время на тест: " << total_duration.count() / tests_count << " мс" << endl;
     
-    // Дополнительная информация о параметрах
-    auto params = findLucasParameters(n);
-    cout << "Параметры теста: D = " << get<0>(params).toString() 
-         << ", P = " << get<1>(params) 
-         << ", Q = " << get<2>(params) << endl;
+    // Дополнительная информация о параметрах (для n без малых делителей)
+    const long long d = n.isOdd() && n > BigInt(2) && smallPrimeFactor(n) == 0 ? BigInt::selfridgeD(n) : 0;
+    if (d != 0) {
+        cout << "Параметры теста: D = " << d << ", P = 1, Q = " << (1 - d) / 4 << endl;
+    }
     cout << endl;
 }
 
 // ==================== 3. ТЕСТ BPSW ====================
 
-bool PrimalityTests::bpswTest(const BigInt& n, int iterations) {
-    // BPSW = Miller-Rabin + Lucas-Strong
-    BigInt a = BigInt(2);
-    //return !isWitness(a, n) && lucasStrongTest(n, iterations); //better variant
-    return millerRabinTest(n, iterations) && lucasStrongTest(n, iterations);
+bool PrimalityTests::bpswTest(const BigInt& n, int /*iterations*/) {
+    TRACE_SPAN("bpsw", "primality");
+    // BPSW = Miller-Rabin по основанию 2 + Lucas-Strong; реализация общая
+    // с генерацией простых (BigInt::generateRandomPrime)
+    return BigInt::isPrimeBPSW(n);
 }
 
 void PrimalityTests::bpswStatistics(const BigInt& n, int tests_count) {
+    TRACE_SPAN("bpswStatistics", "statistics");
     cout << "      ТЕСТ BPSW " << endl;
     cout << "Число: " << n.toString() << endl;
     cout << "Количество тестов: " << tests_count << endl;
@@ -429,6 +371,7 @@ void PrimalityTests::bpswStatistics(const BigInt& n, int tests_count) {
 // ==================== 4. СРАВНЕНИЕ ВСЕХ ТЕСТОВ ====================
 
 void PrimalityTests::compareAllTests(const BigInt& n, int tests_count) {
+    TRACE_SPAN("compareAllTests", "statistics");
     cout << "==========================================" << endl;
     cout << "СРАВНЕНИЕ ВСЕХ ТЕСТОВ ДЛЯ ЧИСЛА: " << n.toString() << endl;
     cout << "==========================================" << endl;
@@ -480,6 +423,103 @@ void PrimalityTests::compareAllTests(const BigInt& n, int tests_count) {
     cout << "==========================================" << endl << endl;
 }
 
+// ==================== 6. ПАКЕТНАЯ ПРОВЕРКА ====================
+
+// Дерево произведений: tree[0] - листья, tree[k][i] = tree[k-1][2i] * tree[k-1][2i+1]
+static vector<vector<BigInt>> productTree(const vector<BigInt>& leaves) {
+    vector<vector<BigInt>> tree(1, leaves);
+    while (tree.back().size() > 1) {
+        const vector<BigInt>& level = tree.back();
+        vector<BigInt> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            next.push_back(i + 1 < level.size() ? level[i] * level[i + 1] : level[i]);
+        }
+        tree.push_back(next);
+    }
+    return tree;
+}
+
+// Дерево остатков: x mod tree[0][i] для всех листьев; остаток узла
+// берется от остатка родителя, поэтому x делится целиком только один раз
+static vector<BigInt> remainderTree(const BigInt& x, const vector<vector<BigInt>>& tree) {
+    vector<BigInt> remainders(1, x % tree.back()[0]);
+    for (size_t k = tree.size() - 1; k-- > 0;) {
+        vector<BigInt> next;
+        for (size_t i = 0; i < tree[k].size(); ++i) {
+            next.push_back(remainders[i / 2] % tree[k][i]);
+        }
+        remainders.swap(next);
+    }
+    return remainders;
+}
+
+vector<bool> PrimalityTests::isPrimeBatch(const vector<BigInt>& numbers, unsigned threads, int sieve_limit) {
+    TRACE_SPAN("isPrimeBatch", "primality");
+    sieve_limit = max(sieve_limit, 3);
+    vector<bool> composite(sieve_limit, false);
+    vector<BigInt> primes;
+    for (int i = 2; i < sieve_limit; ++i) {
+        if (composite[i]) continue;
+        primes.push_back(BigInt(i));
+        for (long long j = 1LL * i * i; j < sieve_limit; j += i) composite[j] = true;
+    }
+    
+    // Числа меньше sieve_limit решаются таблицей, остальные идут в решето
+    vector<char> result(numbers.size(), 0);
+    vector<size_t> positions;
+    vector<BigInt> leaves;
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        const BigInt& n = numbers[i];
+        if (n < BigInt(2)) continue;
+        if (n < BigInt(sieve_limit)) {
+            result[i] = !composite[stoi(n.toString())];
+        } else {
+            positions.push_back(i);
+            leaves.push_back(n);
+        }
+    }
+    if (leaves.empty()) return vector<bool>(result.begin(), result.end());
+    
+    // Решето: у n_i нет делителей меньше sieve_limit, если gcd(P mod n_i, n_i) = 1
+    vector<size_t> survivors;
+    {
+        TRACE_SPAN("isPrimeBatch.sieve", "primality");
+        const BigInt product = productTree(primes).back()[0];
+        vector<BigInt> remainders = remainderTree(product, productTree(leaves));
+        for (size_t j = 0; j < leaves.size(); ++j) {
+            if (BigInt::gcd(remainders[j], leaves[j]) == BigInt(1)) survivors.push_back(j);
+        }
+    }
+    
+    // BPSW для оставшихся чисел; потоки разбирают номера общим счетчиком
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > survivors.size()) threads = static_cast<unsigned>(survivors.size());
+    
+    atomic<size_t> next(0);
+    exception_ptr error;
+    mutex error_mutex;
+    auto worker = [&]() {
+        for (size_t k = next++; k < survivors.size(); k = next++) {
+            try {
+                const size_t j = survivors[k];
+                result[positions[j]] = bpswTest(leaves[j]);
+            } catch (...) {
+                lock_guard<mutex> lock(error_mutex);
+                if (!error) error = current_exception();
+                next = survivors.size();
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.push_back(thread(worker));
+    worker();
+    for (auto& t : pool) t.join();
+    if (error) rethrow_exception(error);
+    
+    return vector<bool>(result.begin(), result.end());
+}
+
 // ==================== ГЕНЕРАЦИЯ ТЕСТОВЫХ ЧИСЕЛ ====================
 
 vector<BigInt> PrimalityTests::generateTestNumbers(int min_digits, int max_digits, int count) {
@@ -496,10 +536,13 @@ vector<BigInt> PrimalityTests::generateTestNumbers(int min_digits, int max_digit
 }
 
 void PrimalityTests::runComprehensiveAnalysis() {
+    TRACE_SPAN("runComprehensiveAnalysis", "statistics");
     cout << "==========================================" << endl;
     cout << "КОМПЛЕКСНЫЙ АНАЛИЗ ВЕРОЯТНОСТНЫХ ТЕСТОВ" << endl;
     cout << "==========================================" << endl;
     
+    BigIntStats::reset();
+
     // Известные простые числа для тестирования
     vector<BigInt> test_primes = {
         BigInt("1000000007"),      // 10 цифр
@@ -512,4 +555,8 @@ void PrimalityTests::runComprehensiveAnalysis() {
     for (const auto& prime : test_primes) {
         compareAllTests(prime, 50); // 50 тестов для каждого числа
     }
+
+    if (BigIntStats::enabled()) {
+        BigIntStats::print(cout);
+    }
 }
\ No newline at end of file
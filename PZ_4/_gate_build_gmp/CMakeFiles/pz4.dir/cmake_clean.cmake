@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pz4.dir/main/main_practical4.cpp.o"
+  "CMakeFiles/pz4.dir/main/main_practical4.cpp.o.d"
+  "pz4"
+  "pz4.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pz4.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pz4_lib.dir/src/bigint.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/bigint.cpp.o.d"
+  "CMakeFiles/pz4_lib.dir/src/bigint_gmp.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/bigint_gmp.cpp.o.d"
+  "CMakeFiles/pz4_lib.dir/src/bigint_stats.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/bigint_stats.cpp.o.d"
+  "CMakeFiles/pz4_lib.dir/src/checkpoint.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/checkpoint.cpp.o.d"
+  "CMakeFiles/pz4_lib.dir/src/deterministic_primality.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/deterministic_primality.cpp.o.d"
+  "CMakeFiles/pz4_lib.dir/src/polynomial.cpp.o"
+  "CMakeFiles/pz4_lib.dir/src/polynomial.cpp.o.d"
+  "libpz4_lib.a"
+  "libpz4_lib.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pz4_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
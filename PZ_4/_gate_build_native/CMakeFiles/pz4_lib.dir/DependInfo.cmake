@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/PZ_4/src/bigint.cpp" "CMakeFiles/pz4_lib.dir/src/bigint.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/bigint.cpp.o.d"
+  "/root/repo/PZ_4/src/bigint_native.cpp" "CMakeFiles/pz4_lib.dir/src/bigint_native.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/bigint_native.cpp.o.d"
+  "/root/repo/PZ_4/src/bigint_stats.cpp" "CMakeFiles/pz4_lib.dir/src/bigint_stats.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/bigint_stats.cpp.o.d"
+  "/root/repo/PZ_4/src/checkpoint.cpp" "CMakeFiles/pz4_lib.dir/src/checkpoint.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/checkpoint.cpp.o.d"
+  "/root/repo/PZ_4/src/deterministic_primality.cpp" "CMakeFiles/pz4_lib.dir/src/deterministic_primality.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/deterministic_primality.cpp.o.d"
+  "/root/repo/PZ_4/src/polynomial.cpp" "CMakeFiles/pz4_lib.dir/src/polynomial.cpp.o" "gcc" "CMakeFiles/pz4_lib.dir/src/polynomial.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
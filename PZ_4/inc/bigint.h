@@ -12,9 +12,27 @@
 #include <cmath>
 #include <map>
 
+// Арифметическое ядро выбирается при сборке (CMake: -DBIGINT_BACKEND=native|gmp):
+//  - native: собственная реализация, число хранится как массив десятичных цифр
+//  - gmp:    число хранится в mpz_class, операции выполняет GMP
+#ifdef BIGINT_BACKEND_GMP
+#include <gmpxx.h>
+#endif
+
+#include "bigint_stats.h"
+
+struct CheckpointConfig;
+
 class BigInt {
 private:
+#ifdef BIGINT_BACKEND_GMP
+    mpz_class value;
+#else
+#ifdef BIGINT_STATS
+    std::vector<int, BigIntStatsAllocator<int>> digits;
+#else
     std::vector<int> digits;
+#endif
     bool isNegative;
 
     void removeLeadingZeros();
@@ -23,6 +41,7 @@ private:
     BigInt subtractAbsolute(const BigInt& other) const;
     BigInt multiplyByDigit(int digit) const;
     BigInt divideByDigit(int digit) const;
+#endif
 
 public:
     // ==================== КОНСТРУКТОРЫ ====================
@@ -148,7 +167,7 @@ public:
     /**
      * Возвращает количество цифр в числе
      */
-    size_t getDigitCount() const { return digits.size(); }
+    size_t getDigitCount() const;
 
     // ==================== НОВЫЕ МЕТОДЫ ДЛЯ ДОСТУПА К ЦИФРАМ ====================
     
@@ -157,33 +176,22 @@ public:
      * @param index - индекс цифры (0 - младший разряд)
      * @return цифра в указанной позиции
      */
-    int getDigitAt(size_t index) const {
-        if (index < digits.size()) {
-            return digits[index];
-        }
-        return 0;
-    }
+    int getDigitAt(size_t index) const;
     
     /**
      * Возвращает младшую цифру числа (последнюю цифру в десятичном представлении)
      */
-    int getLastDigit() const {
-        return digits.empty() ? 0 : digits[0];
-    }
+    int getLastDigit() const;
     
     /**
-     * Возвращает все цифры числа (только для чтения)
+     * Возвращает все цифры числа (младшие разряды в начале)
      */
-    const std::vector<int>& getDigits() const {
-        return digits;
-    }
+    std::vector<int> getDigits() const;
     
     /**
      * Проверяет, является ли число четным
      */
-    bool isEven() const {
-        return digits.empty() ? true : (digits[0] % 2 == 0);
-    }
+    bool isEven() const;
     
     /**
      * Проверяет, является ли число нечетным
@@ -216,10 +224,12 @@ public:
      * Возвращает знак числа
      * @return 1 если положительное, -1 если отрицательное, 0 если ноль
      */
-    int sign() const {
-        if (isZero()) return 0;
-        return isNegative ? -1 : 1;
-    }
+    int sign() const;
+
+    /**
+     * Название арифметического ядра, с которым собрана библиотека ("native" или "gmp")
+     */
+    static const char* backendName();
 
     // ==================== СТАТИЧЕСКИЕ МАТЕМАТИЧЕСКИЕ ФУНКЦИИ ====================
 
@@ -239,12 +249,53 @@ public:
 
     /**
      * Генерация случайного простого числа заданной длины
+     * От случайного числа перебираются нечетные кандидаты: окна смещений
+     * просеиваются малыми простыми (остатки начала считаются один раз),
+     * оставшиеся кандидаты проверяются тестом BPSW
      * @param numDigits - количество цифр в числе
      * @param gen - генератор случайных чисел
-     * @return случайное простое число
+     * @return вероятно простое число из numDigits цифр
      */
     static BigInt generateRandomPrime(int numDigits, std::mt19937& gen);
 
+    /**
+     * Генерация случайного простого числа заданной битности (тот же поиск)
+     * @param numBits - количество бит в числе
+     * @param gen - генератор случайных чисел
+     * @return вероятно простое число из numBits бит
+     */
+    static BigInt generateRandomPrimeBits(int numBits, std::mt19937& gen);
+
+    /**
+     * Параметр Селфриджа для теста Люка: первое D из 5, -7, 9, -11, ...
+     * с символом Якоби (D/n) = -1
+     * @param n - нечетное число без простых делителей меньше 100
+     * @return D или 0, если n - полный квадрат или имеет общий делитель с D
+     */
+    static long long selfridgeD(const BigInt& n);
+
+    /**
+     * Сильный тест Люка с параметрами Селфриджа (P = 1, Q = (1 - D) / 4):
+     * U_k, V_k и Q^k за одну лестницу по битам k, где n + 1 = 2^s * k.
+     * Единственная реализация, общая с isPrimeBPSW
+     * @param n - нечетное число без простых делителей меньше 100
+     * @return true если n - сильное вероятно простое Люка
+     */
+    static bool isStrongLucasProbablePrime(const BigInt& n);
+
+    /**
+     * Тот же тест с периодическим сохранением состояния лестницы (задача "lucas")
+     */
+    static bool isStrongLucasProbablePrime(const BigInt& n, const CheckpointConfig& checkpoint);
+
+    /**
+     * Тест BPSW: пробное деление на простые до 100, сильный тест Ферма
+     * по основанию 2 и сильный тест Люка с параметрами Селфриджа.
+     * Единственная реализация, общая с генерацией простых
+     * @return true если n вероятно простое, false если составное
+     */
+    static bool isPrimeBPSW(const BigInt& n);
+
     /**
      * Проверка числа на простоту (тест Миллера-Рабина)
      * @param iterations - количество итераций теста
@@ -273,6 +324,21 @@ public:
      * Тест Люка-Лемера для чисел Мерсенна
      */
     static bool lucasLehmerTest(int p);
+
+    /**
+     * Тест Люка-Лемера с периодическим сохранением состояния
+     * @param p - показатель числа Мерсенна
+     * @param checkpoint - настройки контрольных точек (при resume продолжает
+     *                     с последней корректной точки для того же p)
+     */
+    static bool lucasLehmerTest(int p, const CheckpointConfig& checkpoint);
+
+    /**
+     * Продолжение теста Люка-Лемера с последней корректной контрольной точки.
+     * Показатель p берется из самой контрольной точки.
+     * @param checkpoint - настройки контрольных точек (path обязателен)
+     */
+    static bool resumeLucasLehmerTest(const CheckpointConfig& checkpoint);
     
     /**
      * Вычисление квадратного корня (бинарный поиск)
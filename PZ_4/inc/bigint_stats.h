@@ -0,0 +1,136 @@
+#ifndef BIGINT_STATS_H
+#define BIGINT_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+// Счетчики операций BigInt включаются при сборке (CMake: -DBIGINT_STATS=ON).
+// Без BIGINT_STATS макросы BIGINT_STATS_* раскрываются в пустоту, аргументы
+// не вычисляются, а методы BigIntStats возвращают нулевой снимок.
+
+/**
+ * Снимок счетчиков операций BigInt
+ *
+ * Операции разбиты по размеру большего операнда (в десятичных цифрах);
+ * границы корзин соответствуют 64, 128, ..., 4096 битам.
+ * Учитываются только внешние вызовы: умножения и вычитания внутри деления,
+ * корня или modPow относятся к вызвавшей их операции.
+ */
+struct BigIntStatsSnapshot {
+    enum Operation {
+        ADD, SUB, MUL, DIV, MOD, POW, MODPOW, GCD, SQRT,
+        OPERATION_COUNT
+    };
+
+    static const int BUCKET_COUNT = 8;
+
+    uint64_t operations[OPERATION_COUNT][BUCKET_COUNT];
+    uint64_t allocations;      // выделения памяти под цифры / лимбы
+    uint64_t allocatedBytes;   // суммарный объем выделенной памяти
+    uint64_t temporaries;      // созданные объекты BigInt (включая копии)
+
+    BigIntStatsSnapshot();
+
+    uint64_t total(Operation op) const;
+
+    static const char* operationName(Operation op);
+
+    /**
+     * Верхняя граница корзины в цифрах (0 - последняя корзина без границы)
+     */
+    static size_t bucketLimit(int bucket);
+
+    static int bucketFor(size_t digits);
+};
+
+/**
+ * Сбор и вывод счетчиков операций BigInt
+ */
+class BigIntStats {
+public:
+    /**
+     * Собрана ли библиотека со счетчиками
+     */
+    static bool enabled();
+
+    /**
+     * Текущие значения счетчиков
+     */
+    static BigIntStatsSnapshot snapshot();
+
+    /**
+     * Обнуляет счетчики
+     */
+    static void reset();
+
+    /**
+     * Печатает ненулевые счетчики в виде таблицы
+     */
+    static void print(std::ostream& os, const BigIntStatsSnapshot& stats);
+    static void print(std::ostream& os = std::cout);
+
+    // Точки учета, вызываются из арифметического ядра через макросы ниже
+    static void countAllocation(size_t bytes);
+    static void countTemporary();
+
+    /**
+     * Учитывает операцию, если она не вложена в другую учитываемую операцию
+     */
+    class Scope {
+        bool outer;
+
+    public:
+        Scope(BigIntStatsSnapshot::Operation op, size_t digits);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#ifdef BIGINT_STATS
+
+#define BIGINT_STATS_CONCAT_(a, b) a##b
+#define BIGINT_STATS_CONCAT(a, b) BIGINT_STATS_CONCAT_(a, b)
+#define BIGINT_STATS_OPERATION(op, digits) \
+    BigIntStats::Scope BIGINT_STATS_CONCAT(bigintStatsScope, __LINE__)(BigIntStatsSnapshot::op, (digits))
+#define BIGINT_STATS_TEMPORARY() BigIntStats::countTemporary()
+#define BIGINT_STATS_ALLOCATION(bytes) BigIntStats::countAllocation(bytes)
+
+/**
+ * Аллокатор для массива цифр собственного ядра, учитывающий выделения памяти
+ */
+template <typename T>
+struct BigIntStatsAllocator {
+    typedef T value_type;
+
+    BigIntStatsAllocator() = default;
+    template <typename U>
+    BigIntStatsAllocator(const BigIntStatsAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        BigIntStats::countAllocation(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const BigIntStatsAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const BigIntStatsAllocator<U>&) const { return false; }
+};
+
+#else
+
+#define BIGINT_STATS_OPERATION(op, digits) ((void)0)
+#define BIGINT_STATS_TEMPORARY() ((void)0)
+#define BIGINT_STATS_ALLOCATION(bytes) ((void)0)
+
+#endif
+
+#endif
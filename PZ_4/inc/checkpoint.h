@@ -0,0 +1,109 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "bigint.h"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Настройки периодического сохранения состояния длительных вычислений
+ * (Люка-Лемер, AKS, лестницы Люка).
+ *
+ * Сохранение срабатывает, когда выполнено хотя бы одно из условий:
+ * прошло everyIterations итераций или прошло everySeconds секунд
+ * с момента последнего сохранения. Нулевое значение отключает условие.
+ */
+struct CheckpointConfig {
+    std::string path;           // базовый путь (создаются файлы path.0 и path.1)
+    long long everyIterations;  // интервал в итерациях (0 - не использовать)
+    double everySeconds;        // интервал по времени в секундах (0 - не использовать)
+    bool resume;                // продолжать с последней корректной точки, если она есть
+    bool removeOnFinish;        // удалять файлы после успешного завершения
+
+    explicit CheckpointConfig(const std::string& path = "",
+                              long long everyIterations = 0,
+                              double everySeconds = 60.0,
+                              bool resume = true,
+                              bool removeOnFinish = true)
+        : path(path), everyIterations(everyIterations), everySeconds(everySeconds),
+          resume(resume), removeOnFinish(removeOnFinish) {}
+
+    bool enabled() const { return !path.empty(); }
+};
+
+/**
+ * Состояние вычисления, хранящееся в контрольной точке
+ */
+struct CheckpointState {
+    std::string task;              // имя задачи: "lucas-lehmer", "aks", "lucas"
+    std::string key;               // параметры задачи (p, n, ...) - для проверки при возобновлении
+    long long iteration;           // индекс следующей итерации
+    std::vector<BigInt> residues;  // текущие остатки
+    uint64_t sequence;             // порядковый номер записи (выбирается самая новая)
+
+    CheckpointState() : iteration(0), sequence(0) {}
+};
+
+/**
+ * Запись и чтение контрольных точек в двоичном формате.
+ *
+ * Формат записи (little-endian):
+ *   "BICK" | версия u32 | номер u64 | задача | ключ | итерация i64 |
+ *   число остатков u32 | остатки | контрольная сумма FNV-1a u64
+ * Строки и остатки хранятся как длина u32 + байты; остаток - знак u8 и
+ * десятичная запись модуля, поэтому формат не зависит от представления BigInt.
+ *
+ * Записи чередуются между двумя файлами (path.0, path.1) и пишутся через
+ * временный файл с переименованием, так что сбой во время записи
+ * не портит предыдущую корректную точку.
+ */
+class Checkpointer {
+private:
+    CheckpointConfig config;
+    std::string task;
+    std::string key;
+    uint64_t sequence;
+    long long lastIteration;
+    std::chrono::steady_clock::time_point lastSave;
+
+    std::string slotPath(int slot) const;
+
+public:
+    Checkpointer(const CheckpointConfig& config, const std::string& task, const std::string& key);
+
+    /**
+     * Загружает последнюю корректную точку этой задачи (с тем же ключом)
+     * @return true если состояние восстановлено
+     */
+    bool resume(CheckpointState& state);
+
+    /**
+     * Проверяет, пора ли сохранять состояние на данной итерации
+     */
+    bool due(long long iteration) const;
+
+    /**
+     * Сохраняет состояние (iteration - индекс следующей итерации)
+     */
+    void save(long long iteration, const std::vector<BigInt>& residues);
+
+    /**
+     * Вызывается после завершения вычисления
+     */
+    void finish();
+
+    /**
+     * Читает самую новую корректную запись по базовому пути
+     * @return false если ни одна запись не прошла проверку
+     */
+    static bool loadLatest(const std::string& path, CheckpointState& state);
+
+    /**
+     * Удаляет файлы контрольных точек
+     */
+    static void remove(const std::string& path);
+};
+
+#endif
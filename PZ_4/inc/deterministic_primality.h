@@ -3,6 +3,7 @@
 
 #include "bigint.h"
 #include "polynomial.h"
+#include "checkpoint.h"
 #include <vector>
 #include <cmath>
 #include <chrono>
@@ -14,7 +15,9 @@ private:
     static BigInt findSmallestR(const BigInt& n);
     static BigInt multiplicativeOrder(const BigInt& a, const BigInt& n);
     static BigInt eulerTotient(const BigInt& n);
-    static bool checkPolynomialAKS(const BigInt& n, const BigInt& r);
+    static bool checkPolynomialAKS(const BigInt& n, const BigInt& r,
+                                   Checkpointer* saver = nullptr,
+                                   BigInt start_a = BigInt(1), long long step = 0);
     
     // Вспомогательные методы для Миллера
     static void factorOutTwos(BigInt n_minus_one, BigInt& d, int& s);
@@ -28,6 +31,18 @@ public:
      * Детерминированный тест Агравала-Каяла-Саксены (AKS) - ПОЛНАЯ РЕАЛИЗАЦИЯ
      */
     static bool aksTest(const BigInt& n);
+
+    /**
+     * AKS с периодическим сохранением состояния (шаги 3 и 5).
+     * При resume продолжает с последней корректной точки для того же n.
+     */
+    static bool aksTest(const BigInt& n, const CheckpointConfig& checkpoint);
+
+    /**
+     * Продолжение AKS с последней корректной контрольной точки
+     * (число n берется из самой контрольной точки)
+     */
+    static bool resumeAksTest(const CheckpointConfig& checkpoint);
     
     /**
      * Детерминированный тест Миллера - ПОЛНАЯ РЕАЛИЗАЦИЯ
@@ -1,424 +1,11 @@
 #include "bigint.h"
+#include "checkpoint.h"
+#include <cstdint>
 
 using namespace std;
 
-// ==================== РЕАЛИЗАЦИЯ ОСНОВНЫХ МЕТОДОВ ====================
-
-void BigInt::removeLeadingZeros() {
-    while (digits.size() > 1 && digits.back() == 0) {
-        digits.pop_back();
-    }
-    if (digits.size() == 1 && digits[0] == 0) {
-        isNegative = false;
-    }
-}
-
-int BigInt::compareAbsolute(const BigInt& other) const {
-    if (digits.size() != other.digits.size()) {
-        return digits.size() < other.digits.size() ? -1 : 1;
-    }
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        if (digits[i] != other.digits[i]) {
-            return digits[i] < other.digits[i] ? -1 : 1;
-        }
-    }
-    return 0;
-}
-
-BigInt BigInt::addAbsolute(const BigInt& other) const {
-    BigInt result;
-    result.digits.resize(max(digits.size(), other.digits.size()) + 1, 0);
-
-    int carry = 0;
-    for (size_t i = 0; i < result.digits.size(); ++i) {
-        int sum = carry;
-        if (i < digits.size()) sum += digits[i];
-        if (i < other.digits.size()) sum += other.digits[i];
-
-        result.digits[i] = sum % 10;
-        carry = sum / 10;
-    }
-
-    result.removeLeadingZeros();
-    return result;
-}
-
-BigInt BigInt::subtractAbsolute(const BigInt& other) const {
-    if (compareAbsolute(other) < 0) {
-        BigInt result = other.subtractAbsolute(*this);
-        result.isNegative = true;
-        return result;
-    }
-
-    BigInt result;
-    result.digits.resize(digits.size(), 0);
-
-    int borrow = 0;
-    for (size_t i = 0; i < digits.size(); ++i) {
-        int diff = digits[i] - borrow;
-        if (i < other.digits.size()) {
-            diff -= other.digits[i];
-        }
-
-        if (diff < 0) {
-            diff += 10;
-            borrow = 1;
-        } else {
-            borrow = 0;
-        }
-
-        result.digits[i] = diff;
-    }
-
-    result.removeLeadingZeros();
-    return result;
-}
-
-BigInt BigInt::multiplyByDigit(int digit) const {
-    if (digit == 0) return BigInt(0);
-
-    BigInt result;
-    result.digits.resize(digits.size() + 1, 0);
-
-    int carry = 0;
-    for (size_t i = 0; i < digits.size(); ++i) {
-        int product = digits[i] * digit + carry;
-        result.digits[i] = product % 10;
-        carry = product / 10;
-    }
-
-    if (carry > 0) {
-        result.digits[digits.size()] = carry;
-    }
-
-    result.removeLeadingZeros();
-    return result;
-}
-
-BigInt BigInt::divideByDigit(int digit) const {
-    if (digit == 0) {
-        throw runtime_error("Division by zero");
-    }
-
-    BigInt result;
-    result.digits.resize(digits.size(), 0);
-
-    int remainder = 0;
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        int current = remainder * 10 + digits[i];
-        result.digits[i] = current / digit;
-        remainder = current % digit;
-    }
-
-    result.removeLeadingZeros();
-    return result;
-}
-
-BigInt::BigInt() : isNegative(false) {
-    digits.push_back(0);
-}
-
-BigInt::BigInt(const string& str) {
-    if (str.empty()) {
-        digits.push_back(0);
-        isNegative = false;
-        return;
-    }
-
-    size_t start = 0;
-    if (str[0] == '-') {
-        isNegative = true;
-        start = 1;
-    } else if (str[0] == '+') {
-        isNegative = false;
-        start = 1;
-    } else {
-        isNegative = false;
-    }
-
-    for (int i = str.size() - 1; i >= (int)start; --i) {
-        if (isdigit(str[i])) {
-            digits.push_back(str[i] - '0');
-        } else {
-            throw invalid_argument("Invalid character in number string");
-        }
-    }
-
-    removeLeadingZeros();
-}
-
-BigInt::BigInt(long long num) {
-    if (num < 0) {
-        isNegative = true;
-        num = -num;
-    } else {
-        isNegative = false;
-    }
-
-    if (num == 0) {
-        digits.push_back(0);
-        return;
-    }
-
-    while (num > 0) {
-        digits.push_back(num % 10);
-        num /= 10;
-    }
-}
-
-BigInt::BigInt(const BigInt& other)
-    : digits(other.digits), isNegative(other.isNegative) {}
-
-BigInt::BigInt(int numDigits, mt19937& gen) {
-    if (numDigits <= 0) {
-        throw invalid_argument("Invalid number of digits");
-    }
-
-    uniform_int_distribution<int> dist(1, 9);
-    digits.push_back(dist(gen));
-
-    uniform_int_distribution<int> dist2(0, 9);
-    for (int i = 1; i < numDigits; ++i) {
-        digits.push_back(dist2(gen));
-    }
-
-    reverse(digits.begin(), digits.end());
-    isNegative = false;
-}
-
-BigInt& BigInt::operator=(const BigInt& other) {
-    if (this != &other) {
-        digits = other.digits;
-        isNegative = other.isNegative;
-    }
-    return *this;
-}
-
-BigInt& BigInt::operator=(long long num) {
-    *this = BigInt(num);
-    return *this;
-}
-
-BigInt BigInt::operator+(const BigInt& other) const {
-    if (isNegative == other.isNegative) {
-        BigInt result = addAbsolute(other);
-        result.isNegative = isNegative;
-        return result;
-    }
-
-    int cmp = compareAbsolute(other);
-    if (cmp == 0) {
-        return BigInt(0);
-    }
-
-    BigInt result;
-    if (cmp > 0) {
-        result = subtractAbsolute(other);
-        result.isNegative = isNegative;
-    } else {
-        result = other.subtractAbsolute(*this);
-        result.isNegative = other.isNegative;
-    }
-
-    return result;
-}
-
-BigInt BigInt::operator-(const BigInt& other) const {
-    return *this + (-other);
-}
-
-BigInt BigInt::operator*(const BigInt& other) const {
-    if (isZero() || other.isZero()) {
-        return BigInt(0);
-    }
-
-    BigInt result;
-    result.digits.resize(digits.size() + other.digits.size(), 0);
-
-    for (size_t i = 0; i < digits.size(); ++i) {
-        int carry = 0;
-        for (size_t j = 0; j < other.digits.size() || carry; ++j) {
-            long long product = result.digits[i + j] +
-                digits[i] * (j < other.digits.size() ? other.digits[j] : 0) +
-                carry;
-            result.digits[i + j] = product % 10;
-            carry = product / 10;
-        }
-    }
-
-    result.isNegative = isNegative != other.isNegative;
-    result.removeLeadingZeros();
-    return result;
-}
-
-BigInt BigInt::operator/(const BigInt& other) const {
-    if (other.isZero()) {
-        throw runtime_error("Division by zero");
-    }
-
-    BigInt absOther = other.abs();
-    if (absOther.compareAbsolute(*this) > 0) {
-        return BigInt(0);
-    }
-
-    BigInt quotient, remainder;
-    quotient.digits.resize(digits.size(), 0);
-
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        remainder = remainder * BigInt(10) + BigInt(digits[i]);
-        int count = 0;
-        while (remainder.compareAbsolute(absOther) >= 0) {
-            remainder = remainder - absOther;
-            count++;
-        }
-        quotient.digits[i] = count;
-    }
-
-    quotient.isNegative = isNegative != other.isNegative;
-    quotient.removeLeadingZeros();
-    return quotient;
-}
-
-BigInt BigInt::operator%(const BigInt& other) const {
-    if (other.isZero()) {
-        throw runtime_error("Division by zero");
-    }
-
-    BigInt absOther = other.abs();
-    BigInt remainder;
-
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        remainder = remainder * BigInt(10) + BigInt(digits[i]);
-        while (remainder.compareAbsolute(absOther) >= 0) {
-            remainder = remainder - absOther;
-        }
-    }
-
-    remainder.isNegative = isNegative;
-    if (remainder.isNegative && !remainder.isZero()) {
-        remainder = remainder + absOther;
-    }
-
-    return remainder;
-}
-
-BigInt BigInt::operator^(const BigInt& exponent) const {
-    if (exponent.isNegative) {
-        throw runtime_error("Negative exponents not supported");
-    }
-
-    if (exponent.isZero()) {
-        return BigInt(1);
-    }
-
-    BigInt result(1);
-    BigInt base = *this;
-    BigInt exp = exponent;
-
-    while (!exp.isZero()) {
-        if (exp.digits[0] % 2 == 1) {
-            result = result * base;
-        }
-        base = base * base;
-        exp = exp / BigInt(2);
-    }
-
-    return result;
-}
-
-bool BigInt::operator==(const BigInt& other) const {
-    return isNegative == other.isNegative && digits == other.digits;
-}
-
-bool BigInt::operator!=(const BigInt& other) const {
-    return !(*this == other);
-}
-
-bool BigInt::operator<(const BigInt& other) const {
-    if (isNegative != other.isNegative) {
-        return isNegative;
-    }
-
-    if (isNegative) {
-        return compareAbsolute(other) > 0;
-    } else {
-        return compareAbsolute(other) < 0;
-    }
-}
-
-bool BigInt::operator<=(const BigInt& other) const {
-    return *this < other || *this == other;
-}
-
-bool BigInt::operator>(const BigInt& other) const {
-    return !(*this <= other);
-}
-
-bool BigInt::operator>=(const BigInt& other) const {
-    return !(*this < other);
-}
-
-BigInt BigInt::operator-() const {
-    BigInt result = *this;
-    if (!result.isZero()) {
-        result.isNegative = !result.isNegative;
-    }
-    return result;
-}
-
-BigInt BigInt::operator+() const {
-    return *this;
-}
-
-ostream& operator<<(ostream& os, const BigInt& num) {
-    if (num.isNegative) {
-        os << '-';
-    }
-    for (int i = num.digits.size() - 1; i >= 0; --i) {
-        os << num.digits[i];
-    }
-    return os;
-}
-
-istream& operator>>(istream& is, BigInt& num) {
-    string str;
-    is >> str;
-    num = BigInt(str);
-    return is;
-}
-
-string BigInt::toString() const {
-    string result;
-    if (isNegative) {
-        result += '-';
-    }
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        result += to_string(digits[i]);
-    }
-    return result;
-}
-
-bool BigInt::isZero() const {
-    return digits.size() == 1 && digits[0] == 0;
-}
-
-BigInt BigInt::abs() const {
-    BigInt result = *this;
-    result.isNegative = false;
-    return result;
-}
-
-BigInt BigInt::gcd(BigInt a, BigInt b) {
-    a = a.abs();
-    b = b.abs();
-
-    while (!b.isZero()) {
-        BigInt temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
-}
+// Алгоритмы, не зависящие от арифметического ядра: используют только
+// публичный интерфейс BigInt и работают с любым backend.
 
 BigInt BigInt::lcm(const BigInt& a, const BigInt& b) {
     if (a.isZero() || b.isZero()) {
@@ -429,68 +16,19 @@ BigInt BigInt::lcm(const BigInt& a, const BigInt& b) {
 
 // ==================== МЕТОДЫ ПРОВЕРКИ ПРОСТОТЫ ====================
 
-// Вычисление квадратного корня (бинарный поиск)
-BigInt BigInt::sqrt(const BigInt& n) {
-    if (n < BigInt(0)) {
-        throw invalid_argument("Square root of negative number");
-    }
-    if (n.isZero()) return BigInt(0);
-    if (n == BigInt(1)) return BigInt(1);
-
-    BigInt low(1), high = n;
-    BigInt result(1);
-
-    while (low <= high) {
-        BigInt mid = (low + high) / BigInt(2);
-        BigInt square = mid * mid;
-
-        if (square == n) {
-            return mid;
-        } else if (square < n) {
-            low = mid + BigInt(1);
-            result = mid;
-        } else {
-            high = mid - BigInt(1);
-        }
-    }
-
-    return result;
-}
-
-// Модульное возведение в степень
-BigInt BigInt::modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
-    if (mod == BigInt(1)) return BigInt(0);
-    
-    BigInt result(1);
-    BigInt b = base % mod;
-    BigInt exp = exponent;
-    
-    while (!exp.isZero()) {
-        if (exp.digits[0] % 2 == 1) {
-            result = (result * b) % mod;
-        }
-        b = (b * b) % mod;
-        exp = exp / BigInt(2);
-    }
-    
-    return result;
-}
-
 // 1. Стандартный метод проверки простоты
 bool BigInt::isPrimeStandard(const BigInt& n) {
     if (n < BigInt(2)) return false;
     if (n == BigInt(2)) return true;
     
     // Проверка на четность
-    if (n.digits[0] % 2 == 0) return false;
+    if (n.isEven()) return false;
     
     // Проверка деления на 5
-    if (n.digits[0] == 5 || n.digits[0] == 0) return n == BigInt(5);
+    if (n.getLastDigit() == 5) return n == BigInt(5);
     
-    // Проверка суммы цифр на делимость на 3
-    int sum = 0;
-    for (int digit : n.digits) sum += digit;
-    if (sum % 3 == 0) return n == BigInt(3);
+    // Проверка делимости на 3
+    if (n % BigInt(3) == BigInt(0)) return n == BigInt(3);
     
     // Проверка всех чисел до квадратного корня
     BigInt i(3);
@@ -587,43 +125,342 @@ bool BigInt::isPrimeAtkin(const BigInt& n, int limit) {
 
 // 4. Тест Люка-Лемера для чисел Мерсенна
 bool BigInt::lucasLehmerTest(int p) {
+    return lucasLehmerTest(p, CheckpointConfig());
+}
+
+bool BigInt::lucasLehmerTest(int p, const CheckpointConfig& checkpoint) {
     if (p < 2) return false;
     if (p == 2) return true;
     
     // Вычисляем число Мерсенна M_p = 2^p - 1
     BigInt mersenne = (BigInt(2) ^ BigInt(p)) - BigInt(1);
     BigInt s(4);
+    long long start = 0;
+    
+    // Состояние: индекс итерации и текущий остаток s
+    Checkpointer saver(checkpoint, "lucas-lehmer", to_string(p));
+    CheckpointState state;
+    if (saver.resume(state) && state.residues.size() == 1) {
+        s = state.residues[0];
+        start = state.iteration;
+    }
     
-    for (int i = 0; i < p - 2; ++i) {
+    for (long long i = start; i < p - 2; ++i) {
         s = (s * s - BigInt(2)) % mersenne;
+        if (saver.due(i + 1)) {
+            saver.save(i + 1, {s});
+        }
     }
     
+    saver.finish();
     return s.isZero();
 }
 
+bool BigInt::resumeLucasLehmerTest(const CheckpointConfig& checkpoint) {
+    CheckpointState state;
+    if (!Checkpointer::loadLatest(checkpoint.path, state) || state.task != "lucas-lehmer") {
+        throw runtime_error("No valid Lucas-Lehmer checkpoint: " + checkpoint.path);
+    }
+    
+    CheckpointConfig config = checkpoint;
+    config.resume = true;
+    return lucasLehmerTest(stoi(state.key), config);
+}
+
 // Упрощенная проверка простоты для демонстрации
 bool BigInt::isPrime(int iterations) const {
     return isPrimeStandard(*this);
 }
 
+// ==================== ГЕНЕРАЦИЯ СЛУЧАЙНЫХ ПРОСТЫХ ====================
+
+namespace {
+
+// Простые решета кандидатов и ширина окна (число нечетных смещений)
+const uint32_t CANDIDATE_SIEVE_LIMIT = 1 << 16;
+const size_t CANDIDATE_WINDOW = 1 << 12;
+
+// Нечетные простые меньше CANDIDATE_SIEVE_LIMIT
+const vector<uint32_t>& candidateSievePrimes() {
+    static const vector<uint32_t> primes = [] {
+        vector<bool> composite(CANDIDATE_SIEVE_LIMIT, false);
+        vector<uint32_t> result;
+        for (uint32_t i = 3; i < CANDIDATE_SIEVE_LIMIT; i += 2) {
+            if (composite[i]) continue;
+            result.push_back(i);
+            for (uint64_t j = (uint64_t)i * i; j < CANDIDATE_SIEVE_LIMIT; j += 2 * i) {
+                composite[j] = true;
+            }
+        }
+        return result;
+    }();
+    return primes;
+}
+
+// Остатки неотрицательного числа по модулям primes: десятичная запись
+// разбирается один раз на части по 9 цифр
+vector<uint32_t> smallResidues(const BigInt& n, const vector<uint32_t>& primes) {
+    const string s = n.toString();
+    vector<uint32_t> chunks;
+    size_t first = s.size() % 9 == 0 ? 9 : s.size() % 9;
+    for (size_t pos = 0; pos < s.size(); pos = first, first += 9) {
+        chunks.push_back(static_cast<uint32_t>(stoul(s.substr(pos, first - pos))));
+    }
+
+    vector<uint32_t> residues(primes.size());
+    for (size_t i = 0; i < primes.size(); ++i) {
+        uint64_t r = 0;
+        for (uint32_t chunk : chunks) {
+            r = (r * 1000000000ULL + chunk) % primes[i];
+        }
+        residues[i] = static_cast<uint32_t>(r);
+    }
+    return residues;
+}
+
+// Остаток неотрицательного числа по малому модулю
+uint32_t smallResidue(const BigInt& n, uint32_t m) {
+    return smallResidues(n, vector<uint32_t>(1, m))[0];
+}
+
+// Сильный тест Ферма по основанию 2 (нечетное n > 2)
+bool strongProbablePrimeBase2(const BigInt& n) {
+    const BigInt one(1), n_minus_1 = n - one;
+    BigInt d = n_minus_1;
+    int s = 0;
+    while (d.isEven()) {
+        d = d / BigInt(2);
+        ++s;
+    }
+    BigInt x = BigInt::modPow(BigInt(2), d, n);
+    if (x == one || x == n_minus_1) return true;
+    for (int r = 1; r < s; ++r) {
+        x = (x * x) % n;
+        if (x == n_minus_1) return true;
+    }
+    return false;
+}
+
+// Символ Якоби (d/n) для малого нечетного d и нечетного n > |d|:
+// по закону взаимности сводится к остаткам n mod 4 и n mod |d|
+int jacobiSmall(long long d, const BigInt& n) {
+    int result = 1;
+    const uint32_t n_mod_4 = smallResidue(n, 4);
+    if (d < 0) {
+        d = -d;
+        if (n_mod_4 == 3) result = -result;    // (-1/n)
+    }
+    if (d % 4 == 3 && n_mod_4 == 3) result = -result;
+    // Дальше (n mod d / d) в машинных словах
+    long long a = smallResidue(n, static_cast<uint32_t>(d)), m = d;
+    while (a != 0) {
+        while (a % 2 == 0) {
+            a /= 2;
+            if (m % 8 == 3 || m % 8 == 5) result = -result;
+        }
+        swap(a, m);
+        if (a % 4 == 3 && m % 4 == 3) result = -result;
+        a %= m;
+    }
+    return m == 1 ? result : 0;
+}
+
+// (a + b) / 2 mod n для a, b из [0, n), n нечетное
+BigInt halfSumMod(const BigInt& a, const BigInt& b, const BigInt& n) {
+    BigInt sum = a + b;
+    if (sum.isOdd()) sum = sum + n;
+    return (sum / BigInt(2)) % n;
+}
+
+// Остаток малого x любого знака по модулю n > |x|
+BigInt smallModulo(long long x, const BigInt& n) {
+    return x >= 0 ? BigInt(x) % n : n - BigInt(-x) % n;
+}
+
+// Ключ контрольной точки лестницы Люка: k, P, Q и модуль n последним полем
+// (по нему находится тест при продолжении с контрольной точки)
+string lucasCheckpointKey(const BigInt& k, long long q, const BigInt& n) {
+    return k.toString() + ";1;" + to_string(q) + ";" + n.toString();
+}
+
+// Первое вероятно простое (BPSW) среди нечетных start, start + 2, ... не больше last.
+// Остатки start по простым решета считаются один раз и сдвигаются от окна
+// к окну; в окне составные смещения отмечаются в битовом массиве, BPSW
+// получают только оставшиеся. false - на отрезке простых нет
+bool nextSievedPrime(BigInt start, const BigInt& last, BigInt& prime) {
+    if (start.isEven()) start = start + BigInt(1);
+    const vector<uint32_t>& primes = candidateSievePrimes();
+    vector<uint32_t> residues = smallResidues(start, primes);
+    // Малое start может само оказаться простым из решета
+    const bool small_start = start < BigInt(CANDIDATE_SIEVE_LIMIT);
+    const uint64_t start_value = small_start ? stoull(start.toString()) : 0;
+
+    vector<bool> composite(CANDIDATE_WINDOW);
+    const long long window_span = 2 * static_cast<long long>(CANDIDATE_WINDOW);
+    uint64_t offset = 0;
+    for (BigInt base = start; base <= last; base = base + BigInt(window_span), offset += window_span) {
+        fill(composite.begin(), composite.end(), false);
+        for (size_t i = 0; i < primes.size(); ++i) {
+            // base + 2j = 0 (mod p) при j = -r / 2 = (p - r) * (p + 1) / 2 (mod p)
+            const uint64_t p = primes[i];
+            uint64_t j = (p - residues[i]) % p * ((p + 1) / 2) % p;
+            for (; j < CANDIDATE_WINDOW; j += p) {
+                if (small_start && start_value + offset + 2 * j == p) continue;
+                composite[j] = true;
+            }
+            residues[i] = static_cast<uint32_t>((residues[i] + window_span) % p);
+        }
+
+        for (size_t j = 0; j < CANDIDATE_WINDOW; ++j) {
+            if (composite[j]) continue;
+            BigInt candidate = base + BigInt(static_cast<long long>(2 * j));
+            if (candidate > last) return false;
+            if (BigInt::isPrimeBPSW(candidate)) {
+                prime = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+long long BigInt::selfridgeD(const BigInt& n) {
+    // D = 5, -7, 9, -11, ...; у полного квадрата (D/n) = -1 не бывает,
+    // поэтому после 20 неудачных D проверяется, не квадрат ли n
+    long long d = 5;
+    for (int tries = 0;; ++tries) {
+        const int j = jacobiSmall(d, n);
+        if (j == -1) return d;
+        if (j == 0) return 0;
+        if (tries == 20) {
+            BigInt root = BigInt::sqrt(n);
+            if (root * root == n) return 0;
+        }
+        d = d > 0 ? -(d + 2) : -d + 2;
+    }
+}
+
+bool BigInt::isStrongLucasProbablePrime(const BigInt& n) {
+    return isStrongLucasProbablePrime(n, CheckpointConfig());
+}
+
+bool BigInt::isStrongLucasProbablePrime(const BigInt& n, const CheckpointConfig& checkpoint) {
+    const long long d = selfridgeD(n);
+    if (d == 0) return false;
+
+    // P = 1, Q = (1 - D) / 4; все величины по модулю n
+    const long long q = (1 - d) / 4;
+    const BigInt D = smallModulo(d, n), Q = smallModulo(q, n);
+
+    // n + 1 = 2^s * k, k нечетное
+    BigInt k = n + BigInt(1);
+    int s = 0;
+    while (k.isEven()) {
+        k = k / BigInt(2);
+        ++s;
+    }
+
+    // Лестница по битам k от старшего, состояние (U_m, V_m, Q^m), m = 1 в начале.
+    // Удвоение: U_2m = U_m * V_m, V_2m = V_m^2 - 2Q^m;
+    // шаг: U_m+1 = (U_m + V_m) / 2, V_m+1 = (D * U_m + V_m) / 2.
+    // В контрольной точке - число пройденных битов и эта тройка
+    vector<BigInt> state = {BigInt(1), BigInt(1), Q};
+    Checkpointer saver(checkpoint, "lucas", checkpoint.enabled() ? lucasCheckpointKey(k, q, n) : "");
+    CheckpointState saved;
+    long long step = 0;
+    if (saver.resume(saved) && saved.residues.size() == 3) {
+        state = saved.residues;
+        step = saved.iteration;
+    }
+    BigInt& U = state[0];
+    BigInt& V = state[1];
+    BigInt& Qm = state[2];
+    const vector<int> bits = k.toBinary();    // bits[i] - i-й бит, от младшего
+    for (long long i = static_cast<long long>(bits.size()) - 2 - step; i >= 0; --i) {
+        U = (U * V) % n;
+        V = (V * V + n * BigInt(2) - Qm * BigInt(2)) % n;
+        Qm = (Qm * Qm) % n;
+        if (bits[i]) {
+            BigInt next_u = halfSumMod(U, V, n);
+            V = halfSumMod((D * U) % n, V, n);
+            U = next_u;
+            Qm = (Qm * Q) % n;
+        }
+        ++step;
+        if (saver.due(step)) {
+            saver.save(step, state);
+        }
+    }
+    // Итоговое состояние сохраняется, чтобы при возобновлении лестница не пересчитывалась
+    // (если файлы удаляются по завершении, сохранять его незачем)
+    if (checkpoint.enabled() && !checkpoint.removeOnFinish) {
+        saver.save(step, state);
+    }
+    saver.finish();
+
+    // U_k = 0 или V_(k*2^r) = 0 при некотором 0 <= r < s
+    if (U.isZero() || V.isZero()) return true;
+    for (int r = 1; r < s; ++r) {
+        V = (V * V + n * BigInt(2) - Qm * BigInt(2)) % n;
+        if (V.isZero()) return true;
+        Qm = (Qm * Qm) % n;
+    }
+    return false;
+}
+
+bool BigInt::isPrimeBPSW(const BigInt& n) {
+    if (n < BigInt(2)) return false;
+    if (n.isEven()) return n == BigInt(2);
+
+    // Нечетные простые до 100; после них n > |D| для теста Люка
+    const vector<uint32_t>& primes = candidateSievePrimes();
+    const vector<uint32_t> trial(primes.begin(), primes.begin() + 24);
+    const vector<uint32_t> residues = smallResidues(n, trial);
+    for (size_t i = 0; i < trial.size(); ++i) {
+        if (residues[i] == 0) return n == BigInt(static_cast<long long>(trial[i]));
+    }
+    return strongProbablePrimeBase2(n) && isStrongLucasProbablePrime(n);
+}
+
 BigInt BigInt::generateRandomPrime(int numDigits, mt19937& gen) {
     if (numDigits <= 0) {
         throw invalid_argument("Invalid number of digits");
     }
+    if (numDigits == 1) {
+        const int small[] = {2, 3, 5, 7};
+        return BigInt(small[uniform_int_distribution<int>(0, 3)(gen)]);
+    }
 
-    BigInt candidate(numDigits, gen);
-    
-    // Убедимся, что число нечетное
-    if (candidate.digits[0] % 2 == 0) {
-        candidate.digits[0] += 1;
+    // Случайная точка отрезка [10^(d-1), 10^d - 1]; если до его конца
+    // простых нет, берется новая
+    const BigInt last = (BigInt(10) ^ BigInt(numDigits)) - BigInt(1);
+    BigInt prime;
+    while (!nextSievedPrime(BigInt(numDigits, gen), last, prime)) {
     }
+    return prime;
+}
 
-    // Простой поиск следующего простого числа
-    while (!candidate.isPrime()) {
-        candidate = candidate + BigInt(2);
+BigInt BigInt::generateRandomPrimeBits(int numBits, mt19937& gen) {
+    if (numBits < 2) {
+        throw invalid_argument("Invalid number of bits");
     }
 
-    return candidate;
+    // Старший бит 1, остальные случайные, по 16 бит за шаг
+    const BigInt last = (BigInt(2) ^ BigInt(numBits)) - BigInt(1);
+    uniform_int_distribution<int> chunk(0, 0xFFFF);
+    BigInt prime;
+    while (true) {
+        BigInt start(1);
+        for (int left = numBits - 1; left > 0; left -= 16) {
+            const int take = min(left, 16);
+            start = start * BigInt(1LL << take) + BigInt(chunk(gen) >> (16 - take));
+        }
+        if (nextSievedPrime(start, last, prime)) {
+            return prime;
+        }
+    }
 }
 
 // ==================== РЕАЛИЗАЦИЯ МЕТОДОВ для ПЗ 4 ====================
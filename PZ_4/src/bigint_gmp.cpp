@@ -0,0 +1,324 @@
+#include "bigint.h"
+#include "trace.h"
+
+using namespace std;
+
+// Арифметическое ядро на GMP: число хранится в mpz_class.
+// Используется при сборке с BIGINT_BACKEND=gmp. Семантика операций совпадает
+// с собственным ядром (деление с усечением к нулю, остаток % всегда неотрицателен).
+
+#ifdef BIGINT_STATS
+// Размер операнда для счетчиков операций (оценка GMP, может быть больше на 1)
+static size_t statsDigits(const mpz_class& x) {
+    return mpz_sizeinbase(x.get_mpz_t(), 10);
+}
+
+// Учет выделений памяти GMP: обертки над функциями, установленными по умолчанию.
+// Считаются все выделения mpz в процессе, не только внутри BigInt.
+static void* (*gmpAllocate)(size_t);
+static void* (*gmpReallocate)(void*, size_t, size_t);
+static void (*gmpFree)(void*, size_t);
+
+static void* countingAllocate(size_t size) {
+    BIGINT_STATS_ALLOCATION(size);
+    return gmpAllocate(size);
+}
+
+static void* countingReallocate(void* ptr, size_t oldSize, size_t newSize) {
+    BIGINT_STATS_ALLOCATION(newSize);
+    return gmpReallocate(ptr, oldSize, newSize);
+}
+
+static struct GmpAllocationHook {
+    GmpAllocationHook() {
+        mp_get_memory_functions(&gmpAllocate, &gmpReallocate, &gmpFree);
+        mp_set_memory_functions(countingAllocate, countingReallocate, gmpFree);
+    }
+} gmpAllocationHook;
+#endif
+
+// ==================== КОНСТРУКТОРЫ ====================
+
+BigInt::BigInt() : value(0) {
+    BIGINT_STATS_TEMPORARY();
+}
+
+BigInt::BigInt(const string& str) : value(0) {
+    BIGINT_STATS_TEMPORARY();
+    if (str.empty()) {
+        return;
+    }
+
+    size_t start = (str[0] == '-' || str[0] == '+') ? 1 : 0;
+    for (size_t i = start; i < str.size(); ++i) {
+        if (!isdigit(static_cast<unsigned char>(str[i]))) {
+            throw invalid_argument("Invalid character in number string");
+        }
+    }
+    if (start == str.size()) {
+        return;
+    }
+
+    value.set_str(str.substr(start), 10);
+    if (str[0] == '-') {
+        value = -value;
+    }
+}
+
+BigInt::BigInt(long long num) {
+    BIGINT_STATS_TEMPORARY();
+    // mpz_class не принимает long long напрямую на всех платформах
+    bool negative = num < 0;
+    unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(num)
+                                            : static_cast<unsigned long long>(num);
+    mpz_import(value.get_mpz_t(), 1, -1, sizeof(magnitude), 0, 0, &magnitude);
+    if (negative) {
+        value = -value;
+    }
+}
+
+BigInt::BigInt(const BigInt& other) : value(other.value) {
+    BIGINT_STATS_TEMPORARY();
+}
+
+BigInt::BigInt(int numDigits, mt19937& gen) {
+    BIGINT_STATS_TEMPORARY();
+    if (numDigits <= 0) {
+        throw invalid_argument("Invalid number of digits");
+    }
+
+    // Та же последовательность обращений к генератору, что и в собственном ядре:
+    // первой генерируется старшая (ненулевая) цифра
+    string str;
+    uniform_int_distribution<int> dist(1, 9);
+    str.push_back(static_cast<char>('0' + dist(gen)));
+
+    uniform_int_distribution<int> dist2(0, 9);
+    for (int i = 1; i < numDigits; ++i) {
+        str.push_back(static_cast<char>('0' + dist2(gen)));
+    }
+
+    value.set_str(str, 10);
+}
+
+// ==================== ПРИСВАИВАНИЕ ====================
+
+BigInt& BigInt::operator=(const BigInt& other) {
+    value = other.value;
+    return *this;
+}
+
+BigInt& BigInt::operator=(long long num) {
+    *this = BigInt(num);
+    return *this;
+}
+
+// ==================== АРИФМЕТИКА ====================
+
+BigInt BigInt::operator+(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(ADD, max(statsDigits(value), statsDigits(other.value)));
+    BigInt result;
+    result.value = value + other.value;
+    return result;
+}
+
+BigInt BigInt::operator-(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(SUB, max(statsDigits(value), statsDigits(other.value)));
+    BigInt result;
+    result.value = value - other.value;
+    return result;
+}
+
+BigInt BigInt::operator*(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(MUL, max(statsDigits(value), statsDigits(other.value)));
+    BigInt result;
+    result.value = value * other.value;
+    return result;
+}
+
+BigInt BigInt::operator/(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(DIV, max(statsDigits(value), statsDigits(other.value)));
+    if (other.isZero()) {
+        throw runtime_error("Division by zero");
+    }
+
+    BigInt result;
+    mpz_tdiv_q(result.value.get_mpz_t(), value.get_mpz_t(), other.value.get_mpz_t());
+    return result;
+}
+
+BigInt BigInt::operator%(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(MOD, max(statsDigits(value), statsDigits(other.value)));
+    if (other.isZero()) {
+        throw runtime_error("Division by zero");
+    }
+
+    BigInt result;
+    mpz_mod(result.value.get_mpz_t(), value.get_mpz_t(), other.value.get_mpz_t());
+    return result;
+}
+
+BigInt BigInt::operator^(const BigInt& exponent) const {
+    BIGINT_STATS_OPERATION(POW, statsDigits(value));
+    if (exponent.sign() < 0) {
+        throw runtime_error("Negative exponents not supported");
+    }
+    if (!exponent.value.fits_ulong_p()) {
+        throw runtime_error("Exponent is too large");
+    }
+
+    BigInt result;
+    mpz_pow_ui(result.value.get_mpz_t(), value.get_mpz_t(), exponent.value.get_ui());
+    return result;
+}
+
+// ==================== СРАВНЕНИЕ ====================
+
+bool BigInt::operator==(const BigInt& other) const {
+    return cmp(value, other.value) == 0;
+}
+
+bool BigInt::operator!=(const BigInt& other) const {
+    return cmp(value, other.value) != 0;
+}
+
+bool BigInt::operator<(const BigInt& other) const {
+    return cmp(value, other.value) < 0;
+}
+
+bool BigInt::operator<=(const BigInt& other) const {
+    return cmp(value, other.value) <= 0;
+}
+
+bool BigInt::operator>(const BigInt& other) const {
+    return cmp(value, other.value) > 0;
+}
+
+bool BigInt::operator>=(const BigInt& other) const {
+    return cmp(value, other.value) >= 0;
+}
+
+// ==================== УНАРНЫЕ ОПЕРАТОРЫ ====================
+
+BigInt BigInt::operator-() const {
+    BigInt result;
+    result.value = -value;
+    return result;
+}
+
+BigInt BigInt::operator+() const {
+    return *this;
+}
+
+// ==================== ВВОД/ВЫВОД ====================
+
+ostream& operator<<(ostream& os, const BigInt& num) {
+    os << num.value.get_str(10);
+    return os;
+}
+
+istream& operator>>(istream& is, BigInt& num) {
+    string str;
+    is >> str;
+    num = BigInt(str);
+    return is;
+}
+
+// ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
+
+string BigInt::toString() const {
+    return value.get_str(10);
+}
+
+bool BigInt::isZero() const {
+    return sgn(value) == 0;
+}
+
+BigInt BigInt::abs() const {
+    BigInt result;
+    result.value = ::abs(value);
+    return result;
+}
+
+size_t BigInt::getDigitCount() const {
+    // mpz_sizeinbase может завысить результат на единицу - уточняем сравнением с 10^(k-1)
+    size_t count = mpz_sizeinbase(value.get_mpz_t(), 10);
+    if (count > 1) {
+        mpz_class lower;
+        mpz_ui_pow_ui(lower.get_mpz_t(), 10, count - 1);
+        if (mpz_cmpabs(value.get_mpz_t(), lower.get_mpz_t()) < 0) {
+            --count;
+        }
+    }
+    return count;
+}
+
+int BigInt::getDigitAt(size_t index) const {
+    string str = mpz_class(::abs(value)).get_str(10);
+    if (index < str.size()) {
+        return str[str.size() - 1 - index] - '0';
+    }
+    return 0;
+}
+
+int BigInt::getLastDigit() const {
+    return static_cast<int>(mpz_tdiv_ui(value.get_mpz_t(), 10));
+}
+
+vector<int> BigInt::getDigits() const {
+    string str = mpz_class(::abs(value)).get_str(10);
+    vector<int> result;
+    result.reserve(str.size());
+    for (size_t i = str.size(); i-- > 0;) {
+        result.push_back(str[i] - '0');
+    }
+    return result;
+}
+
+bool BigInt::isEven() const {
+    return mpz_even_p(value.get_mpz_t()) != 0;
+}
+
+int BigInt::sign() const {
+    return sgn(value);
+}
+
+const char* BigInt::backendName() {
+    return "gmp";
+}
+
+// ==================== ОПЕРАЦИИ ЯДРА ====================
+
+BigInt BigInt::gcd(BigInt a, BigInt b) {
+    BIGINT_STATS_OPERATION(GCD, max(statsDigits(a.value), statsDigits(b.value)));
+    BigInt result;
+    mpz_gcd(result.value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_mpz_t());
+    return result;
+}
+
+BigInt BigInt::sqrt(const BigInt& n) {
+    BIGINT_STATS_OPERATION(SQRT, statsDigits(n.value));
+    if (n.sign() < 0) {
+        throw invalid_argument("Square root of negative number");
+    }
+
+    BigInt result;
+    mpz_sqrt(result.value.get_mpz_t(), n.value.get_mpz_t());
+    return result;
+}
+
+BigInt BigInt::modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
+    TRACE_SPAN("modPow", "arith");
+    BIGINT_STATS_OPERATION(MODPOW, max(statsDigits(base.value), statsDigits(mod.value)));
+    if (mod.isZero()) {
+        throw runtime_error("Division by zero");
+    }
+    if (exponent.sign() < 0) {
+        throw runtime_error("Negative exponents not supported");
+    }
+
+    BigInt result;
+    mpz_powm(result.value.get_mpz_t(), base.value.get_mpz_t(),
+             exponent.value.get_mpz_t(), mod.value.get_mpz_t());
+    return result;
+}
@@ -0,0 +1,523 @@
+#include "bigint.h"
+#include "trace.h"
+
+using namespace std;
+
+// Собственное арифметическое ядро: число хранится как массив десятичных цифр
+// (младшие разряды в начале). Используется при сборке с BIGINT_BACKEND=native.
+
+// ==================== РЕАЛИЗАЦИЯ ОСНОВНЫХ МЕТОДОВ ====================
+
+void BigInt::removeLeadingZeros() {
+    while (digits.size() > 1 && digits.back() == 0) {
+        digits.pop_back();
+    }
+    if (digits.size() == 1 && digits[0] == 0) {
+        isNegative = false;
+    }
+}
+
+int BigInt::compareAbsolute(const BigInt& other) const {
+    if (digits.size() != other.digits.size()) {
+        return digits.size() < other.digits.size() ? -1 : 1;
+    }
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        if (digits[i] != other.digits[i]) {
+            return digits[i] < other.digits[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+BigInt BigInt::addAbsolute(const BigInt& other) const {
+    BigInt result;
+    result.digits.resize(max(digits.size(), other.digits.size()) + 1, 0);
+
+    int carry = 0;
+    for (size_t i = 0; i < result.digits.size(); ++i) {
+        int sum = carry;
+        if (i < digits.size()) sum += digits[i];
+        if (i < other.digits.size()) sum += other.digits[i];
+
+        result.digits[i] = sum % 10;
+        carry = sum / 10;
+    }
+
+    result.removeLeadingZeros();
+    return result;
+}
+
+BigInt BigInt::subtractAbsolute(const BigInt& other) const {
+    if (compareAbsolute(other) < 0) {
+        BigInt result = other.subtractAbsolute(*this);
+        result.isNegative = true;
+        return result;
+    }
+
+    BigInt result;
+    result.digits.resize(digits.size(), 0);
+
+    int borrow = 0;
+    for (size_t i = 0; i < digits.size(); ++i) {
+        int diff = digits[i] - borrow;
+        if (i < other.digits.size()) {
+            diff -= other.digits[i];
+        }
+
+        if (diff < 0) {
+            diff += 10;
+            borrow = 1;
+        } else {
+            borrow = 0;
+        }
+
+        result.digits[i] = diff;
+    }
+
+    result.removeLeadingZeros();
+    return result;
+}
+
+BigInt BigInt::multiplyByDigit(int digit) const {
+    if (digit == 0) return BigInt(0);
+
+    BigInt result;
+    result.digits.resize(digits.size() + 1, 0);
+
+    int carry = 0;
+    for (size_t i = 0; i < digits.size(); ++i) {
+        int product = digits[i] * digit + carry;
+        result.digits[i] = product % 10;
+        carry = product / 10;
+    }
+
+    if (carry > 0) {
+        result.digits[digits.size()] = carry;
+    }
+
+    result.removeLeadingZeros();
+    return result;
+}
+
+BigInt BigInt::divideByDigit(int digit) const {
+    if (digit == 0) {
+        throw runtime_error("Division by zero");
+    }
+
+    BigInt result;
+    result.digits.resize(digits.size(), 0);
+
+    int remainder = 0;
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        int current = remainder * 10 + digits[i];
+        result.digits[i] = current / digit;
+        remainder = current % digit;
+    }
+
+    result.removeLeadingZeros();
+    return result;
+}
+
+BigInt::BigInt() : isNegative(false) {
+    BIGINT_STATS_TEMPORARY();
+    digits.push_back(0);
+}
+
+BigInt::BigInt(const string& str) {
+    BIGINT_STATS_TEMPORARY();
+    if (str.empty()) {
+        digits.push_back(0);
+        isNegative = false;
+        return;
+    }
+
+    size_t start = 0;
+    if (str[0] == '-') {
+        isNegative = true;
+        start = 1;
+    } else if (str[0] == '+') {
+        isNegative = false;
+        start = 1;
+    } else {
+        isNegative = false;
+    }
+
+    for (int i = str.size() - 1; i >= (int)start; --i) {
+        if (isdigit(str[i])) {
+            digits.push_back(str[i] - '0');
+        } else {
+            throw invalid_argument("Invalid character in number string");
+        }
+    }
+
+    removeLeadingZeros();
+}
+
+BigInt::BigInt(long long num) {
+    BIGINT_STATS_TEMPORARY();
+    if (num < 0) {
+        isNegative = true;
+        num = -num;
+    } else {
+        isNegative = false;
+    }
+
+    if (num == 0) {
+        digits.push_back(0);
+        return;
+    }
+
+    while (num > 0) {
+        digits.push_back(num % 10);
+        num /= 10;
+    }
+}
+
+BigInt::BigInt(const BigInt& other)
+    : digits(other.digits), isNegative(other.isNegative) {
+    BIGINT_STATS_TEMPORARY();
+}
+
+BigInt::BigInt(int numDigits, mt19937& gen) {
+    BIGINT_STATS_TEMPORARY();
+    if (numDigits <= 0) {
+        throw invalid_argument("Invalid number of digits");
+    }
+
+    uniform_int_distribution<int> dist(1, 9);
+    digits.push_back(dist(gen));
+
+    uniform_int_distribution<int> dist2(0, 9);
+    for (int i = 1; i < numDigits; ++i) {
+        digits.push_back(dist2(gen));
+    }
+
+    reverse(digits.begin(), digits.end());
+    isNegative = false;
+}
+
+BigInt& BigInt::operator=(const BigInt& other) {
+    if (this != &other) {
+        digits = other.digits;
+        isNegative = other.isNegative;
+    }
+    return *this;
+}
+
+BigInt& BigInt::operator=(long long num) {
+    *this = BigInt(num);
+    return *this;
+}
+
+BigInt BigInt::operator+(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(ADD, max(digits.size(), other.digits.size()));
+    if (isNegative == other.isNegative) {
+        BigInt result = addAbsolute(other);
+        result.isNegative = isNegative;
+        return result;
+    }
+
+    int cmp = compareAbsolute(other);
+    if (cmp == 0) {
+        return BigInt(0);
+    }
+
+    BigInt result;
+    if (cmp > 0) {
+        result = subtractAbsolute(other);
+        result.isNegative = isNegative;
+    } else {
+        result = other.subtractAbsolute(*this);
+        result.isNegative = other.isNegative;
+    }
+
+    return result;
+}
+
+BigInt BigInt::operator-(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(SUB, max(digits.size(), other.digits.size()));
+    return *this + (-other);
+}
+
+BigInt BigInt::operator*(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(MUL, max(digits.size(), other.digits.size()));
+    if (isZero() || other.isZero()) {
+        return BigInt(0);
+    }
+
+    BigInt result;
+    result.digits.resize(digits.size() + other.digits.size(), 0);
+
+    for (size_t i = 0; i < digits.size(); ++i) {
+        int carry = 0;
+        for (size_t j = 0; j < other.digits.size() || carry; ++j) {
+            long long product = result.digits[i + j] +
+                digits[i] * (j < other.digits.size() ? other.digits[j] : 0) +
+                carry;
+            result.digits[i + j] = product % 10;
+            carry = product / 10;
+        }
+    }
+
+    result.isNegative = isNegative != other.isNegative;
+    result.removeLeadingZeros();
+    return result;
+}
+
+BigInt BigInt::operator/(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(DIV, max(digits.size(), other.digits.size()));
+    if (other.isZero()) {
+        throw runtime_error("Division by zero");
+    }
+
+    BigInt absOther = other.abs();
+    if (absOther.compareAbsolute(*this) > 0) {
+        return BigInt(0);
+    }
+
+    BigInt quotient, remainder;
+    quotient.digits.resize(digits.size(), 0);
+
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        remainder = remainder * BigInt(10) + BigInt(digits[i]);
+        int count = 0;
+        while (remainder.compareAbsolute(absOther) >= 0) {
+            remainder = remainder - absOther;
+            count++;
+        }
+        quotient.digits[i] = count;
+    }
+
+    quotient.isNegative = isNegative != other.isNegative;
+    quotient.removeLeadingZeros();
+    return quotient;
+}
+
+BigInt BigInt::operator%(const BigInt& other) const {
+    BIGINT_STATS_OPERATION(MOD, max(digits.size(), other.digits.size()));
+    if (other.isZero()) {
+        throw runtime_error("Division by zero");
+    }
+
+    BigInt absOther = other.abs();
+    BigInt remainder;
+
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        remainder = remainder * BigInt(10) + BigInt(digits[i]);
+        while (remainder.compareAbsolute(absOther) >= 0) {
+            remainder = remainder - absOther;
+        }
+    }
+
+    // Нулевой остаток неотрицателен (иначе "-0" + |other| дает |other|)
+    remainder.isNegative = isNegative && !remainder.isZero();
+    if (remainder.isNegative) {
+        remainder = remainder + absOther;
+    }
+
+    return remainder;
+}
+
+BigInt BigInt::operator^(const BigInt& exponent) const {
+    BIGINT_STATS_OPERATION(POW, digits.size());
+    if (exponent.isNegative) {
+        throw runtime_error("Negative exponents not supported");
+    }
+
+    if (exponent.isZero()) {
+        return BigInt(1);
+    }
+
+    BigInt result(1);
+    BigInt base = *this;
+    BigInt exp = exponent;
+
+    while (!exp.isZero()) {
+        if (exp.digits[0] % 2 == 1) {
+            result = result * base;
+        }
+        base = base * base;
+        exp = exp / BigInt(2);
+    }
+
+    return result;
+}
+
+bool BigInt::operator==(const BigInt& other) const {
+    return isNegative == other.isNegative && digits == other.digits;
+}
+
+bool BigInt::operator!=(const BigInt& other) const {
+    return !(*this == other);
+}
+
+bool BigInt::operator<(const BigInt& other) const {
+    if (isNegative != other.isNegative) {
+        return isNegative;
+    }
+
+    if (isNegative) {
+        return compareAbsolute(other) > 0;
+    } else {
+        return compareAbsolute(other) < 0;
+    }
+}
+
+bool BigInt::operator<=(const BigInt& other) const {
+    return *this < other || *this == other;
+}
+
+bool BigInt::operator>(const BigInt& other) const {
+    return !(*this <= other);
+}
+
+bool BigInt::operator>=(const BigInt& other) const {
+    return !(*this < other);
+}
+
+BigInt BigInt::operator-() const {
+    BigInt result = *this;
+    if (!result.isZero()) {
+        result.isNegative = !result.isNegative;
+    }
+    return result;
+}
+
+BigInt BigInt::operator+() const {
+    return *this;
+}
+
+ostream& operator<<(ostream& os, const BigInt& num) {
+    if (num.isNegative) {
+        os << '-';
+    }
+    for (int i = num.digits.size() - 1; i >= 0; --i) {
+        os << num.digits[i];
+    }
+    return os;
+}
+
+istream& operator>>(istream& is, BigInt& num) {
+    string str;
+    is >> str;
+    num = BigInt(str);
+    return is;
+}
+
+string BigInt::toString() const {
+    string result;
+    if (isNegative) {
+        result += '-';
+    }
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        result += to_string(digits[i]);
+    }
+    return result;
+}
+
+bool BigInt::isZero() const {
+    return digits.size() == 1 && digits[0] == 0;
+}
+
+BigInt BigInt::abs() const {
+    BigInt result = *this;
+    result.isNegative = false;
+    return result;
+}
+
+BigInt BigInt::gcd(BigInt a, BigInt b) {
+    BIGINT_STATS_OPERATION(GCD, max(a.digits.size(), b.digits.size()));
+    a = a.abs();
+    b = b.abs();
+
+    while (!b.isZero()) {
+        BigInt temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+size_t BigInt::getDigitCount() const {
+    return digits.size();
+}
+
+int BigInt::getDigitAt(size_t index) const {
+    if (index < digits.size()) {
+        return digits[index];
+    }
+    return 0;
+}
+
+int BigInt::getLastDigit() const {
+    return digits.empty() ? 0 : digits[0];
+}
+
+vector<int> BigInt::getDigits() const {
+    return vector<int>(digits.begin(), digits.end());
+}
+
+bool BigInt::isEven() const {
+    return digits.empty() ? true : (digits[0] % 2 == 0);
+}
+
+int BigInt::sign() const {
+    if (isZero()) return 0;
+    return isNegative ? -1 : 1;
+}
+
+const char* BigInt::backendName() {
+    return "native";
+}
+
+// ==================== ОПЕРАЦИИ ЯДРА ====================
+
+// Вычисление квадратного корня (бинарный поиск)
+BigInt BigInt::sqrt(const BigInt& n) {
+    BIGINT_STATS_OPERATION(SQRT, n.digits.size());
+    if (n < BigInt(0)) {
+        throw invalid_argument("Square root of negative number");
+    }
+    if (n.isZero()) return BigInt(0);
+    if (n == BigInt(1)) return BigInt(1);
+
+    BigInt low(1), high = n;
+    BigInt result(1);
+
+    while (low <= high) {
+        BigInt mid = (low + high) / BigInt(2);
+        BigInt square = mid * mid;
+
+        if (square == n) {
+            return mid;
+        } else if (square < n) {
+            low = mid + BigInt(1);
+            result = mid;
+        } else {
+            high = mid - BigInt(1);
+        }
+    }
+
+    return result;
+}
+
+// Модульное возведение в степень
+BigInt BigInt::modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
+    TRACE_SPAN("modPow", "arith");
+    BIGINT_STATS_OPERATION(MODPOW, max(base.digits.size(), mod.digits.size()));
+    if (mod == BigInt(1)) return BigInt(0);
+    
+    BigInt result(1);
+    BigInt b = base % mod;
+    BigInt exp = exponent;
+    
+    while (!exp.isZero()) {
+        if (exp.digits[0] % 2 == 1) {
+            result = (result * b) % mod;
+        }
+        b = (b * b) % mod;
+        exp = exp / BigInt(2);
+    }
+    
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "deterministic_primality.h"
+#include "trace.h"
 #include <iostream>
 #include <iomanip>
 #include <random>
@@ -18,6 +19,7 @@ BigInt DeterministicPrimality::sqrt(const BigInt& n) {
 }
 
 bool DeterministicPrimality::isPerfectPower(const BigInt& n) {
+    TRACE_SPAN("aks.perfectPower", "aks");
     if (n < BigInt(2)) return false;
     if (n == BigInt(2)) return false;
     
@@ -80,6 +82,7 @@ BigInt DeterministicPrimality::eulerTotient(const BigInt& n) {
 }
 
 BigInt DeterministicPrimality::findSmallestR(const BigInt& n) {
+    TRACE_SPAN("aks.findR", "aks");
     BigInt log2n = log2Approx(n);
     BigInt max_k = log2n;
     
@@ -100,7 +103,10 @@ BigInt DeterministicPrimality::findSmallestR(const BigInt& n) {
     }
 }
 
-bool DeterministicPrimality::checkPolynomialAKS(const BigInt& n, const BigInt& r) {
+bool DeterministicPrimality::checkPolynomialAKS(const BigInt& n, const BigInt& r,
+                                                Checkpointer* saver,
+                                                BigInt start_a, long long step) {
+    TRACE_SPAN("aks.polynomial", "aks");
     // Упрощенная версия полиномиальной проверки
     // Вместо работы с полиномами используем числовую проверку для нескольких x
     
@@ -118,7 +124,7 @@ bool DeterministicPrimality::checkPolynomialAKS(const BigInt& n, const BigInt& r
     // Проверяем для нескольких значений x
     vector<BigInt> test_x = {BigInt(2), BigInt(3), BigInt(5), BigInt(7)};
     
-    for (BigInt a(1); a <= max_a; a = a + BigInt(1)) {
+    for (BigInt a = start_a; a <= max_a; a = a + BigInt(1)) {
         for (const BigInt& x : test_x) {
             // Проверяем (x + a)^n ≡ x^n + a (mod n)
             BigInt left = BigInt::modPow(x + a, n, n);
@@ -128,6 +134,12 @@ bool DeterministicPrimality::checkPolynomialAKS(const BigInt& n, const BigInt& r
                 return false;
             }
         }
+        
+        // Состояние шага 5: номер шага, r и следующее a
+        ++step;
+        if (saver && saver->due(step)) {
+            saver->save(step, {BigInt(5), r, a + BigInt(1)});
+        }
     }
     
     return true;
@@ -146,37 +158,81 @@ void DeterministicPrimality::factorOutTwos(BigInt n_minus_one, BigInt& d, int& s
 // ==================== ПОЛНАЯ РЕАЛИЗАЦИЯ AKS ====================
 
 bool DeterministicPrimality::aksTest(const BigInt& n) {
+    return aksTest(n, CheckpointConfig());
+}
+
+bool DeterministicPrimality::aksTest(const BigInt& n, const CheckpointConfig& checkpoint) {
+    TRACE_SPAN("aks", "aks");
     // Шаг 1: Проверка степени числа
     if (n == BigInt(2) || n == BigInt(3)) return true;
     if (n < BigInt(2) || n.isEven()) return false;
     
-    if (isPerfectPower(n)) {
-        return false;
-    }
-    
-    // Шаг 2: Находим наименьшее r
-    BigInt r = findSmallestR(n);
-    
-    // Шаг 3: Проверка малых делителей
-    for (BigInt a(2); a <= r && a < n; a = a + BigInt(1)) {
-        BigInt gcd_val = BigInt::gcd(a, n);
-        if (gcd_val > BigInt(1) && gcd_val < n) {
+    // Состояние: {номер шага (3 или 5), r, следующее a}
+    Checkpointer saver(checkpoint, "aks", n.toString());
+    CheckpointState state;
+    BigInt stage(3), r, start_a(2);
+    long long step = 0;
+    
+    if (saver.resume(state) && state.residues.size() == 3) {
+        // Шаги 1-2 уже пройдены при предыдущем запуске
+        stage = state.residues[0];
+        r = state.residues[1];
+        start_a = state.residues[2];
+        step = state.iteration;
+    } else {
+        if (isPerfectPower(n)) {
             return false;
         }
+        
+        // Шаг 2: Находим наименьшее r
+        r = findSmallestR(n);
     }
     
-    // Шаг 4: Если n ≤ r, то число простое
-    if (n <= r) {
-        return true;
+    if (stage == BigInt(3)) {
+        TRACE_SPAN("aks.smallDivisors", "aks");
+        // Шаг 3: Проверка малых делителей
+        for (BigInt a = start_a; a <= r && a < n; a = a + BigInt(1)) {
+            BigInt gcd_val = BigInt::gcd(a, n);
+            if (gcd_val > BigInt(1) && gcd_val < n) {
+                saver.finish();
+                return false;
+            }
+            
+            ++step;
+            if (saver.due(step)) {
+                saver.save(step, {BigInt(3), r, a + BigInt(1)});
+            }
+        }
+        
+        // Шаг 4: Если n ≤ r, то число простое
+        if (n <= r) {
+            saver.finish();
+            return true;
+        }
+        start_a = BigInt(1);
     }
     
     // Шаг 5: Проверка полиномиального сравнения
-    return checkPolynomialAKS(n, r);
+    bool result = checkPolynomialAKS(n, r, &saver, start_a, step);
+    saver.finish();
+    return result;
+}
+
+bool DeterministicPrimality::resumeAksTest(const CheckpointConfig& checkpoint) {
+    CheckpointState state;
+    if (!Checkpointer::loadLatest(checkpoint.path, state) || state.task != "aks") {
+        throw runtime_error("No valid AKS checkpoint: " + checkpoint.path);
+    }
+    
+    CheckpointConfig config = checkpoint;
+    config.resume = true;
+    return aksTest(BigInt(state.key), config);
 }
 
 // ==================== ПОЛНАЯ РЕАЛИЗАЦИЯ ТЕСТА МИЛЛЕРА ====================
 
 bool DeterministicPrimality::millerTest(const BigInt& n) {
+    TRACE_SPAN("miller", "primality");
     if (n < BigInt(2)) return false;
     if (n == BigInt(2)) return true;
     if (n.isEven()) return false;
@@ -253,6 +309,7 @@ bool DeterministicPrimality::millerTest(const BigInt& n) {
 pair<bool, double> DeterministicPrimality::measureTestSpeed(bool (*testFunc)(const BigInt&), 
                                                            const BigInt& n, 
                                                            const string& testName) {
+    TRACE_SPAN("measureTestSpeed", "statistics");
     auto start = chrono::high_resolution_clock::now();
     bool result = testFunc(n);
     auto end = chrono::high_resolution_clock::now();
@@ -276,6 +333,7 @@ pair<bool, double> DeterministicPrimality::measureTestSpeed(bool (*testFunc)(con
 }
 
 void DeterministicPrimality::compareTests(const BigInt& n) {
+    TRACE_SPAN("compareTests", "statistics");
     cout << "==========================================" << endl;
     cout << "СРАВНЕНИЕ ТЕСТОВ ДЛЯ ЧИСЛА: " << n.toString() << endl;
     cout << "==========================================" << endl;
@@ -305,11 +363,14 @@ void DeterministicPrimality::compareTests(const BigInt& n) {
 }
 
 void DeterministicPrimality::runComprehensiveBenchmark() {
+    TRACE_SPAN("runComprehensiveBenchmark", "statistics");
     cout << "==========================================" << endl;
     cout << "КОМПЛЕКСНОЕ ТЕСТИРОВАНИЕ ДЕТЕРМИНИРОВАННЫХ ТЕСТОВ" << endl;
     cout << "Практическая работа №4 - ПОЛНЫЕ РЕАЛИЗАЦИИ" << endl;
     cout << "==========================================" << endl;
     
+    BigIntStats::reset();
+
     // Тестовые числа разного размера
     vector<BigInt> test_numbers = {
         BigInt("1009"),           // Маленькое простое
@@ -322,6 +383,11 @@ void DeterministicPrimality::runComprehensiveBenchmark() {
     for (const auto& num : test_numbers) {
         compareTests(num);
     }
+
+    if (BigIntStats::enabled()) {
+        cout << endl;
+        BigIntStats::print(cout);
+    }
     
     cout << "\nАНАЛИЗ РЕЗУЛЬТАТОВ:" << endl;
     cout << "==========================================" << endl;
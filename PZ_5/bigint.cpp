@@ -1,7 +1,9 @@
 #include "bigint.h"
+#include "trace.h"
 #include <numeric>
 #include <unordered_map>
 #include <functional>
+#include <cstdint>
 
 using namespace std;
 
@@ -460,6 +462,7 @@ BigInt BigInt::sqrt(const BigInt& n) {
 }
 
 BigInt BigInt::modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
+    TRACE_SPAN("modPow", "arith");
     if (mod == BigInt(1)) return BigInt(0);
     
     BigInt result(1);
@@ -688,6 +691,7 @@ BigInt BigInt::randomBigInt(const BigInt& max, mt19937& gen) {
  * @return true если число простое, false если составное
  */
 bool BigInt::isPrimeECPP(int maxAttempts) const {
+    TRACE_SPAN("ecpp", "ecpp");
     BigInt n = *this;  // Работаем с копией числа
     
     // ========== ЭТАП 1: БАЗОВЫЕ ПРОВЕРКИ ==========
@@ -722,6 +726,7 @@ bool BigInt::isPrimeECPP(int maxAttempts) const {
     
     // Многократные попытки найти подходящую эллиптическую кривую
     for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        TRACE_SPAN("ecpp.curve", "ecpp");
         
         // ========== ЭТАП 3.1: ГЕНЕРАЦИЯ ПАРАМЕТРОВ КРИВОЙ ==========
         
@@ -795,6 +800,7 @@ bool BigInt::isPrimeECPP(int maxAttempts) const {
  * @return нетривиальный делитель n или 1 если не найден
  */
 BigInt BigInt::pollardRho(const BigInt& n, int maxIterations) {
+    TRACE_SPAN("pollardRho", "factorization");
     // Базовые случаи
     if (n == BigInt(1)) return BigInt(1);           // 1 не имеет делителей
     if (n % BigInt(2) == BigInt(0)) return BigInt(2);  // Четные числа делятся на 2
@@ -829,6 +835,72 @@ BigInt BigInt::pollardRho(const BigInt& n, int maxIterations) {
     return d;  // Возвращаем найденный делитель (или 1 если не нашли)
 }
 
+// Простые меньше TRIAL_DIVISION_LIMIT, сгруппированные в произведения меньше 2^32
+static const int TRIAL_DIVISION_LIMIT = 10000;
+
+struct SmallPrimeGroups {
+    vector<uint32_t> primes;
+    vector<uint32_t> products;
+    vector<size_t> ends;   // ends[g] - конец группы g в primes
+    BigInt product;        // произведение всех простых
+    
+    SmallPrimeGroups() : product(1) {
+        vector<bool> composite(TRIAL_DIVISION_LIMIT, false);
+        for (int i = 2; i < TRIAL_DIVISION_LIMIT; ++i) {
+            if (composite[i]) continue;
+            primes.push_back(i);
+            for (int j = i * i; j < TRIAL_DIVISION_LIMIT; j += i) composite[j] = true;
+        }
+        
+        uint64_t group = 1;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            if (group * primes[i] > 0xFFFFFFFFULL) {
+                products.push_back(static_cast<uint32_t>(group));
+                ends.push_back(i);
+                group = 1;
+            }
+            group *= primes[i];
+        }
+        products.push_back(static_cast<uint32_t>(group));
+        ends.push_back(primes.size());
+        
+        for (uint32_t p : products) product = product * BigInt(static_cast<long long>(p));
+    }
+};
+
+/**
+ * Пробное деление на все простые меньше 10000 за одно длинное деление:
+ * r = |n| mod P (P - произведение этих простых), затем остатки r по
+ * произведениям-группам и по отдельным простым считаются в машинных словах
+ * @param n - проверяемое число
+ * @return наименьший простой делитель из диапазона или 0
+ */
+int BigInt::smallPrimeFactor(const BigInt& n) {
+    TRACE_SPAN("trialDivision", "factorization");
+    static const SmallPrimeGroups groups;
+    
+    // Остаток - блоками по 9 десятичных цифр (все, кроме первого, полные)
+    const string r = (n.abs() % groups.product).toString();
+    vector<uint32_t> chunks;
+    for (size_t pos = 0, len = r.size() % 9 ? r.size() % 9 : 9; pos < r.size(); pos += len, len = 9) {
+        chunks.push_back(static_cast<uint32_t>(stoul(r.substr(pos, len))));
+    }
+    
+    size_t i = 0;
+    for (size_t g = 0; g < groups.products.size(); ++g) {
+        // Схема Горнера по основанию 10^9 в 64-битной арифметике
+        const uint64_t m = groups.products[g];
+        uint64_t rem = chunks[0] % m;
+        for (size_t c = 1; c < chunks.size(); ++c) {
+            rem = (rem * 1000000000ULL + chunks[c]) % m;
+        }
+        for (; i < groups.ends[g]; ++i) {
+            if (rem % groups.primes[i] == 0) return static_cast<int>(groups.primes[i]);
+        }
+    }
+    return 0;
+}
+
 /**
  * Полная факторизация числа на простые множители
  * @param n - число для факторизации
@@ -836,18 +908,18 @@ BigInt BigInt::pollardRho(const BigInt& n, int maxIterations) {
  * @return вектор простых множителей в порядке возрастания
  */
 vector<BigInt> BigInt::factorize(const BigInt& n, int maxAttempts) {
+    TRACE_SPAN("factorize", "factorization");
     vector<BigInt> factors;  // Результирующий вектор множителей
     BigInt temp = n;         // Временная переменная для разложения
     
     // ========== ЭТАП 1: ПРОВЕРКА МАЛЫХ ПРОСТЫХ ДЕЛИТЕЛЕЙ ==========
     
-    // Список малых простых чисел для последовательной проверки
-    for (int p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
-        // Пока число делится на текущее простое, добавляем его в множители
-        while (temp % BigInt(p) == BigInt(0)) {
-            factors.push_back(BigInt(p));  // Добавляем простой делитель
-            temp = temp / BigInt(p);       // Делим число на найденный множитель
-        }
+    // Простые меньше 10000: каждый поиск делителя - одно длинное деление
+    while (temp > BigInt(1)) {
+        int p = smallPrimeFactor(temp);
+        if (p == 0) break;
+        factors.push_back(BigInt(p));  // Добавляем простой делитель
+        temp = temp / BigInt(p);       // Делим число на найденный множитель
     }
     
     // Если после этого осталась 1 - факторизация завершена
@@ -117,6 +117,8 @@ public:
     
     // Методы факторизации
     static std::vector<BigInt> factorize(const BigInt& n, int maxAttempts = 5);
+    // Наименьший простой делитель |n| меньше 10000 или 0 (одно длинное деление)
+    static int smallPrimeFactor(const BigInt& n);
     static BigInt pollardRho(const BigInt& n, int maxIterations = 1000);
 };
 
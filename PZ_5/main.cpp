@@ -1,5 +1,5 @@
 /*
-g++ -std=c++11 -O2 -o ecpp_test bigint.cpp main.cpp
+g++ -std=c++11 -O2 -I../common -o ecpp_test bigint.cpp main.cpp
 ./ecpp_test
 */
 
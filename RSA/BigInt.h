@@ -1,4 +1,17 @@
 #pragma once
+// Арифметическое ядро выбирается при компиляции: с -DBIGINT_BACKEND_GMP
+// подключается BigInt на mpz_class (BigInt_gmp.h) с тем же интерфейсом.
+// С -DBIGINT_STATS оба ядра считают операции (BigInt_Stats.h).
+#include <cstddef>
+#include <cstdint>
+#include "BigInt_Stats.h"
+
+// Порядок байтов для BigInt::fromBytes / BigInt::toBytes
+enum class ByteOrder { BigEndian, LittleEndian };
+
+#ifdef BIGINT_BACKEND_GMP
+#include "BigInt_gmp.h"
+#else
 #include <iostream>
 #include <vector>
 #include <cstring>
@@ -8,8 +21,30 @@
 using namespace std;
 
 class BigInt {
-    string digits;
+#ifdef BIGINT_STATS
+    typedef vector<uint32_t, BigIntStatsAllocator<uint32_t> > LimbVector;
+#else
+    typedef vector<uint32_t> LimbVector;
+#endif
+    // Двоичные лимбы по 32 бита, младший первым, без старших нулей; ноль - пустой вектор
+    LimbVector limbs;
+
+    // Внутренние операции над лимбами
+    void trim();
+    uint32_t divideSmall(uint32_t divisor);
+    uint32_t remainderSmall(uint32_t divisor) const;
+    void multiplySmallAdd(uint32_t factor, uint32_t addend);
+    std::string decimal() const;
+    static bool parseDecimal(const std::string& s, BigInt& out);
+    static int compare(const BigInt&, const BigInt&);
+    static void divide(const BigInt& a, const BigInt& b, BigInt* quotient, BigInt* remainder);
 public:
+    // Размер большего операнда в десятичных цифрах для счетчиков BigIntStats
+    // (ядро, ModExp_*, НОД)
+    static size_t statsDigits(const BigInt& a, const BigInt& b) {
+        return BigIntStatsSnapshot::digitsForBits(32 * max(a.limbs.size(), b.limbs.size()));
+    }
+
     // Constructors:
     BigInt(unsigned long long n = 0);
     BigInt(const std::string&);
@@ -22,6 +57,10 @@ public:
     friend int Length(const BigInt&);
     int operator[](const int)const;
 
+    // Byte import/export (unsigned, no leading zero bytes; 0 <-> empty)
+    static BigInt fromBytes(const uint8_t* data, size_t length, ByteOrder order = ByteOrder::BigEndian);
+    std::vector<uint8_t> toBytes(ByteOrder order = ByteOrder::BigEndian) const;
+
     /* * * * Operator Overloading * * * */
     // Direct assignment
     BigInt& operator=(const BigInt&);
@@ -103,63 +142,247 @@ public:
     
     // Helper function to convert to int (for testing)
     int to_int() const {
-        int result = 0;
-        for (int i = digits.size() - 1; i >= 0; i--) {
-            result = result * 10 + digits[i];
-        }
-        return result;
+        return limbs.empty() ? 0 : (int)limbs[0];
     }
 };
 
+// Внутренние операции над лимбами
+void BigInt::trim() {
+    while (!limbs.empty() && limbs.back() == 0)
+        limbs.pop_back();
+}
+
+// Деление на 32-битное число на месте, возвращает остаток
+uint32_t BigInt::divideSmall(uint32_t divisor) {
+    uint64_t rem = 0;
+    for (size_t j = limbs.size(); j-- > 0;) {
+        uint64_t cur = (rem << 32) | limbs[j];
+        limbs[j] = (uint32_t)(cur / divisor);
+        rem = cur % divisor;
+    }
+    trim();
+    return (uint32_t)rem;
+}
+
+uint32_t BigInt::remainderSmall(uint32_t divisor) const {
+    uint64_t rem = 0;
+    for (size_t j = limbs.size(); j-- > 0;)
+        rem = ((rem << 32) | limbs[j]) % divisor;
+    return (uint32_t)rem;
+}
+
+// *this = *this * factor + addend
+void BigInt::multiplySmallAdd(uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (size_t j = 0; j < limbs.size(); j++) {
+        uint64_t cur = (uint64_t)limbs[j] * factor + carry;
+        limbs[j] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    if (carry)
+        limbs.push_back((uint32_t)carry);
+    trim();
+}
+
+// Десятичная запись: деление на 10^9, по девять цифр за шаг
+std::string BigInt::decimal() const {
+    if (limbs.empty())
+        return "0";
+    BigInt rest(*this);
+    vector<uint32_t> chunks;  // младшие первыми
+    while (!rest.limbs.empty())
+        chunks.push_back(rest.divideSmall(1000000000));
+
+    std::string s = std::to_string(chunks.back());
+    for (size_t j = chunks.size() - 1; j-- > 0;) {
+        std::string part = std::to_string(chunks[j]);
+        s.append(9 - part.size(), '0');
+        s += part;
+    }
+    return s;
+}
+
+// Разбор десятичной строки по девять цифр за шаг; false, если встретилась не цифра
+bool BigInt::parseDecimal(const std::string& s, BigInt& out) {
+    out.limbs.clear();
+    size_t pos = 0, chunk = s.size() % 9 ? s.size() % 9 : 9;
+    while (pos < s.size()) {
+        uint32_t value = 0, factor = 1;
+        for (size_t k = 0; k < chunk; k++, pos++) {
+            if (!isdigit((unsigned char)s[pos]))
+                return false;
+            value = value * 10 + (s[pos] - '0');
+            factor *= 10;
+        }
+        out.multiplySmallAdd(factor, value);
+        chunk = 9;
+    }
+    return true;
+}
+
+int BigInt::compare(const BigInt& a, const BigInt& b) {
+    if (a.limbs.size() != b.limbs.size())
+        return a.limbs.size() < b.limbs.size() ? -1 : 1;
+    for (size_t j = a.limbs.size(); j-- > 0;)
+        if (a.limbs[j] != b.limbs[j])
+            return a.limbs[j] < b.limbs[j] ? -1 : 1;
+    return 0;
+}
+
+// Деление с остатком (Кнут, алгоритм D); quotient и remainder могут быть нулевыми указателями
+void BigInt::divide(const BigInt& a, const BigInt& b, BigInt* quotient, BigInt* remainder) {
+    if (Null(b))
+        throw("Arithmetic Error: Division By 0");
+    if (compare(a, b) < 0) {
+        if (remainder) *remainder = a;
+        if (quotient) *quotient = BigInt();
+        return;
+    }
+    if (b.limbs.size() == 1) {
+        BigInt q(a);
+        uint32_t r = q.divideSmall(b.limbs[0]);
+        if (quotient) *quotient = q;
+        if (remainder) *remainder = BigInt(r);
+        return;
+    }
+
+    // Нормализация: старший бит делителя должен быть установлен
+    const size_t n = b.limbs.size(), m = a.limbs.size() - n;
+    int shift = 0;
+    for (uint32_t top = b.limbs.back(); !(top & 0x80000000u); top <<= 1)
+        shift++;
+    vector<uint32_t> u(a.limbs.size() + 1, 0), v(n);
+    for (size_t j = 0; j < n; j++)
+        v[j] = (b.limbs[j] << shift) | (shift && j ? b.limbs[j - 1] >> (32 - shift) : 0);
+    for (size_t j = 0; j < a.limbs.size(); j++)
+        u[j] = (a.limbs[j] << shift) | (shift && j ? a.limbs[j - 1] >> (32 - shift) : 0);
+    u[a.limbs.size()] = shift ? a.limbs.back() >> (32 - shift) : 0;
+
+    LimbVector q(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0;) {
+        // Оценка цифры частного по двум старшим лимбам остатка
+        uint64_t top = ((uint64_t)u[j + n] << 32) | u[j + n - 1];
+        uint64_t qhat = top / v[n - 1], rhat = top % v[n - 1];
+        while (qhat > 0xFFFFFFFFu || qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) {
+            qhat--;
+            rhat += v[n - 1];
+            if (rhat > 0xFFFFFFFFu)
+                break;
+        }
+
+        // u[j..j+n] -= qhat * v
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t p = qhat * v[i] + carry;
+            carry = p >> 32;
+            int64_t t = (int64_t)u[i + j] - (int64_t)(uint32_t)p + borrow;
+            u[i + j] = (uint32_t)t;
+            borrow = t >> 32;
+        }
+        int64_t t = (int64_t)u[j + n] - (int64_t)carry + borrow;
+        u[j + n] = (uint32_t)t;
+
+        // Оценка оказалась на единицу больше: возвращаем v
+        if (t < 0) {
+            qhat--;
+            uint64_t c = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t s = (uint64_t)u[i + j] + v[i] + c;
+                u[i + j] = (uint32_t)s;
+                c = s >> 32;
+            }
+            u[j + n] += (uint32_t)c;
+        }
+        q[j] = (uint32_t)qhat;
+    }
+
+    if (quotient) {
+        quotient->limbs.swap(q);
+        quotient->trim();
+    }
+    if (remainder) {
+        remainder->limbs.assign(n, 0);
+        for (size_t j = 0; j < n; j++)
+            remainder->limbs[j] = (u[j] >> shift) | (shift ? u[j + 1] << (32 - shift) : 0);
+        remainder->trim();
+    }
+}
+
 // Constructor implementations
 BigInt::BigInt(const std::string& s) {
-    digits = "";
-    int n = s.size();
-    for (int i = n - 1; i >= 0; i--) {
-        if (!isdigit(s[i]))
-            throw("ERROR");
-        digits.push_back(s[i] - '0');
-    }
+    BIGINT_STATS_TEMPORARY();
+    if (!parseDecimal(s, *this))
+        throw("ERROR");
 }
 
 BigInt::BigInt(unsigned long long nr) {
-    do {
-        digits.push_back(nr % 10);
-        nr /= 10;
-    } while (nr);
+    BIGINT_STATS_TEMPORARY();
+    while (nr) {
+        limbs.push_back((uint32_t)nr);
+        nr >>= 32;
+    }
 }
 
 BigInt::BigInt(const char* s) {
-    digits = "";
-    for (int i = strlen(s) - 1; i >= 0; i--) {
-        if (!isdigit(s[i]))
-            throw("ERROR");
-        digits.push_back(s[i] - '0');
-    }
+    BIGINT_STATS_TEMPORARY();
+    if (!parseDecimal(s, *this))
+        throw("ERROR");
 }
 
 BigInt::BigInt(const BigInt& a) {
-    digits = a.digits;
+    BIGINT_STATS_TEMPORARY();
+    limbs = a.limbs;
+}
+
+// Байты укладываются в лимбы напрямую: основание 2^32 кратно 256
+BigInt BigInt::fromBytes(const uint8_t* data, size_t length, ByteOrder order) {
+    BigInt result;
+    result.limbs.assign((length + 3) / 4, 0);
+    for (size_t i = 0; i < length; i++) {
+        // i - номер байта от младшего
+        uint8_t byte = order == ByteOrder::BigEndian ? data[length - 1 - i] : data[i];
+        result.limbs[i / 4] |= (uint32_t)byte << (8 * (i % 4));
+    }
+    result.trim();
+    return result;
+}
+
+vector<uint8_t> BigInt::toBytes(ByteOrder order) const {
+    vector<uint8_t> bytes;  // младшие первыми
+    bytes.reserve(limbs.size() * 4);
+    for (size_t j = 0; j < limbs.size(); j++)
+        for (int k = 0; k < 4; k++)
+            bytes.push_back((uint8_t)(limbs[j] >> (8 * k)));
+    while (!bytes.empty() && bytes.back() == 0)
+        bytes.pop_back();
+
+    if (order == ByteOrder::BigEndian)
+        reverse(bytes.begin(), bytes.end());
+    return bytes;
 }
 
 bool Null(const BigInt& a) {
-    if (a.digits.size() == 1 && a.digits[0] == 0)
-        return true;
-    return false;
+    return a.limbs.empty();
 }
 
+// Число десятичных цифр (у нуля одна)
 int Length(const BigInt& a) {
-    return a.digits.size();
+    return (int)a.decimal().size();
 }
 
+// Десятичная цифра с номером index (с младшей)
 int BigInt::operator[](const int index)const {
-    if (digits.size() <= index || index < 0)
+    if (index == 0)
+        return (int)remainderSmall(10);
+    std::string s = decimal();
+    if ((int)s.size() <= index || index < 0)
         throw("ERROR");
-    return digits[index];
+    return s[s.size() - 1 - index] - '0';
 }
 
 bool operator==(const BigInt& a, const BigInt& b) {
-    return a.digits == b.digits;
+    return a.limbs == b.limbs;
 }
 
 bool operator!=(const BigInt& a, const BigInt& b) {
@@ -167,13 +390,7 @@ bool operator!=(const BigInt& a, const BigInt& b) {
 }
 
 bool operator<(const BigInt& a, const BigInt& b) {
-    int n = Length(a), m = Length(b);
-    if (n != m)
-        return n < m;
-    while (n--)
-        if (a.digits[n] != b.digits[n])
-            return a.digits[n] < b.digits[n];
-    return false;
+    return BigInt::compare(a, b) < 0;
 }
 
 bool operator>(const BigInt& a, const BigInt& b) {
@@ -189,18 +406,18 @@ bool operator<=(const BigInt& a, const BigInt& b) {
 }
 
 BigInt& BigInt::operator=(const BigInt& a) {
-    digits = a.digits;
+    limbs = a.limbs;
     return *this;
 }
 
 BigInt& BigInt::operator++() {
-    int i, n = digits.size();
-    for (i = 0; i < n && digits[i] == 9; i++)
-        digits[i] = 0;
+    size_t i, n = limbs.size();
+    for (i = 0; i < n && limbs[i] == 0xFFFFFFFFu; i++)
+        limbs[i] = 0;
     if (i == n)
-        digits.push_back(1);
+        limbs.push_back(1);
     else
-        digits[i]++;
+        limbs[i]++;
     return *this;
 }
 
@@ -212,14 +429,13 @@ BigInt BigInt::operator++(int temp) {
 }
 
 BigInt& BigInt::operator--() {
-    if (digits[0] == 0 && digits.size() == 1)
+    if (limbs.empty())
         throw("UNDERFLOW");
-    int i, n = digits.size();
-    for (i = 0; digits[i] == 0 && i < n; i++)
-        digits[i] = 9;
-    digits[i]--;
-    if (n > 1 && digits[n - 1] == 0)
-        digits.pop_back();
+    size_t i;
+    for (i = 0; limbs[i] == 0; i++)
+        limbs[i] = 0xFFFFFFFFu;
+    limbs[i]--;
+    trim();
     return *this;
 }
 
@@ -231,21 +447,18 @@ BigInt BigInt::operator--(int temp) {
 }
 
 BigInt& operator+=(BigInt& a, const BigInt& b) {
-    int t = 0, s, i;
-    int n = Length(a), m = Length(b);
-    if (m > n)
-        a.digits.append(m - n, 0);
-    n = Length(a);
-    for (i = 0; i < n; i++) {
-        if (i < m)
-            s = (a.digits[i] + b.digits[i]) + t;
-        else
-            s = a.digits[i] + t;
-        t = s / 10;
-        a.digits[i] = (s % 10);
+    BIGINT_STATS_OPERATION(ADD, BigInt::statsDigits(a, b));
+    size_t n = b.limbs.size();
+    if (a.limbs.size() < n)
+        a.limbs.resize(n, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.limbs.size() && (i < n || carry); i++) {
+        uint64_t s = (uint64_t)a.limbs[i] + (i < n ? b.limbs[i] : 0) + carry;
+        a.limbs[i] = (uint32_t)s;
+        carry = s >> 32;
     }
-    if (t)
-        a.digits.push_back(t);
+    if (carry)
+        a.limbs.push_back((uint32_t)carry);
     return a;
 }
 
@@ -257,25 +470,17 @@ BigInt operator+(const BigInt& a, const BigInt& b) {
 }
 
 BigInt& operator-=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(SUB, BigInt::statsDigits(a, b));
     if (a < b)
         throw("UNDERFLOW");
-    int n = Length(a), m = Length(b);
-    int i, t = 0, s;
-    for (i = 0; i < n; i++) {
-        if (i < m)
-            s = a.digits[i] - b.digits[i] + t;
-        else
-            s = a.digits[i] + t;
-        if (s < 0)
-            s += 10,
-            t = -1;
-        else
-            t = 0;
-        a.digits[i] = s;
+    size_t n = b.limbs.size();
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.limbs.size() && (i < n || borrow); i++) {
+        int64_t s = (int64_t)a.limbs[i] - (i < n ? b.limbs[i] : 0) + borrow;
+        a.limbs[i] = (uint32_t)s;
+        borrow = s >> 32;
     }
-    while (n > 1 && a.digits[n - 1] == 0)
-        a.digits.pop_back(),
-        n--;
+    a.trim();
     return a;
 }
 
@@ -287,111 +492,59 @@ BigInt operator-(const BigInt& a, const BigInt& b) {
 }
 
 BigInt& operator*=(BigInt& a, const BigInt& b) {
-    if (Null(a) || Null(b)) {
-        a = BigInt();
-        return a;
-    }
-    int n = a.digits.size(), m = b.digits.size();
-    vector<int> v(n + m, 0);
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < m; j++) {
-            v[i + j] += (a.digits[i]) * (b.digits[j]);
-        }
-    n += m;
-    a.digits.resize(v.size());
-    for (int s, i = 0, t = 0; i < n; i++) {
-        s = t + v[i];
-        v[i] = s % 10;
-        t = s / 10;
-        a.digits[i] = v[i];
-    }
-    for (int i = n - 1; i >= 1 && !v[i]; i--)
-        a.digits.pop_back();
+    a = a * b;
     return a;
 }
 
+// Умножение столбиком по 32-битным лимбам
 BigInt operator*(const BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(MUL, BigInt::statsDigits(a, b));
     BigInt temp;
-    temp = a;
-    temp *= b;
+    if (Null(a) || Null(b))
+        return temp;
+    size_t n = a.limbs.size(), m = b.limbs.size();
+    temp.limbs.assign(n + m, 0);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0, ai = a.limbs[i];
+        for (size_t j = 0; j < m; j++) {
+            uint64_t p = ai * b.limbs[j] + temp.limbs[i + j] + carry;
+            temp.limbs[i + j] = (uint32_t)p;
+            carry = p >> 32;
+        }
+        temp.limbs[i + m] = (uint32_t)carry;
+    }
+    temp.trim();
     return temp;
 }
 
 BigInt& operator/=(BigInt& a, const BigInt& b) {
-    if (Null(b))
-        throw("Arithmetic Error: Division By 0");
-    if (a < b) {
-        a = BigInt();
-        return a;
-    }
-    if (a == b) {
-        a = BigInt(1);
-        return a;
-    }
-    int i, lgcat = 0, cc;
-    int n = Length(a), m = Length(b);
-    vector<int> cat(n, 0);
-    BigInt t;
-    for (i = n - 1; t * 10 + a.digits[i] < b; i--) {
-        t *= 10;
-        t += a.digits[i];
-    }
-    for (; i >= 0; i--) {
-        t = t * 10 + a.digits[i];
-        for (cc = 9; cc * b > t; cc--);
-        t -= cc * b;
-        cat[lgcat++] = cc;
-    }
-    a.digits.resize(cat.size());
-    for (i = 0; i < lgcat; i++)
-        a.digits[i] = cat[lgcat - i - 1];
-    a.digits.resize(lgcat);
+    BIGINT_STATS_OPERATION(DIV, BigInt::statsDigits(a, b));
+    BigInt::divide(a, b, &a, nullptr);
     return a;
 }
 
 BigInt operator/(const BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(DIV, BigInt::statsDigits(a, b));
     BigInt temp;
-    temp = a;
-    temp /= b;
+    BigInt::divide(a, b, &temp, nullptr);
     return temp;
 }
 
 BigInt& operator%=(BigInt& a, const BigInt& b) {
-    if (Null(b))
-        throw("Arithmetic Error: Division By 0");
-    if (a < b) {
-        return a;
-    }
-    if (a == b) {
-        a = BigInt();
-        return a;
-    }
-    int i, lgcat = 0, cc;
-    int n = Length(a), m = Length(b);
-    vector<int> cat(n, 0);
-    BigInt t;
-    for (i = n - 1; t * 10 + a.digits[i] < b; i--) {
-        t *= 10;
-        t += a.digits[i];
-    }
-    for (; i >= 0; i--) {
-        t = t * 10 + a.digits[i];
-        for (cc = 9; cc * b > t; cc--);
-        t -= cc * b;
-        cat[lgcat++] = cc;
-    }
-    a = t;
+    BIGINT_STATS_OPERATION(MOD, BigInt::statsDigits(a, b));
+    BigInt::divide(a, b, nullptr, &a);
     return a;
 }
 
 BigInt operator%(const BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(MOD, BigInt::statsDigits(a, b));
     BigInt temp;
-    temp = a;
-    temp %= b;
+    BigInt::divide(a, b, nullptr, &temp);
     return temp;
 }
 
 BigInt& operator^=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(POW, BigInt::statsDigits(a, a));
     BigInt Exponent, Base(a);
     Exponent = b;
     a = 1;
@@ -411,17 +564,13 @@ BigInt operator^(BigInt& a, const BigInt& b) {
 }
 
 void divide_by_2(BigInt& a) {
-    int add = 0;
-    for (int i = a.digits.size() - 1; i >= 0; i--) {
-        int digit = (a.digits[i] >> 1) + add;
-        add = ((a.digits[i] & 1) * 5);
-        a.digits[i] = digit;
-    }
-    while (a.digits.size() > 1 && !a.digits.back())
-        a.digits.pop_back();
+    for (size_t i = 0; i < a.limbs.size(); i++)
+        a.limbs[i] = (a.limbs[i] >> 1) | (i + 1 < a.limbs.size() ? a.limbs[i + 1] << 31 : 0);
+    a.trim();
 }
 
 BigInt sqrt(BigInt& a) {
+    BIGINT_STATS_OPERATION(SQRT, BigInt::statsDigits(a, a));
     BigInt left(1), right(a), v(1), mid, prod;
     divide_by_2(right);
     while (left <= right) {
@@ -445,20 +594,13 @@ BigInt sqrt(BigInt& a) {
 
 istream& operator>>(istream& in, BigInt& a) {
     std::string s; in >> s;
-    a.digits.clear();
-    for (int i = (int)s.size() - 1; i >= 0; --i) {
-        if (!std::isdigit((unsigned char)s[i])) throw("INVALID NUMBER");
-        a.digits.push_back(s[i] - '0');
-    }
+    if (!BigInt::parseDecimal(s, a)) throw("INVALID NUMBER");
     return in;
 }
 
 ostream& operator<<(ostream& out, const BigInt& a) {
-    if (a.digits.empty()) {
-        out << "0";
-    } else {
-        for (int i = a.digits.size() - 1; i >= 0; i--)
-            out << (short)a.digits[i];
-    }
+    out << a.decimal();
     return out;
-}
\ No newline at end of file
+}
+
+#endif // BIGINT_BACKEND_GMP
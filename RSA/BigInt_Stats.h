@@ -0,0 +1,221 @@
+#pragma once
+// Счетчики операций BigInt (заголовочный вариант слоя BigIntStats из PZ_3/PZ_4).
+// Включаются при компиляции с -DBIGINT_STATS; без него макросы BIGINT_STATS_*
+// раскрываются в пустоту, аргументы не вычисляются, а снимок остается нулевым.
+// Учитываются только внешние вызовы: умножения внутри деления или возведения
+// в степень относятся к вызвавшей их операции.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Снимок счетчиков. Операции разбиты по размеру большего операнда
+// в десятичных цифрах; границы корзин - 64, 128, ..., 4096 бит
+struct BigIntStatsSnapshot {
+    enum Operation {
+        ADD, SUB, MUL, DIV, MOD, POW, MODPOW, GCD, SQRT,
+        OPERATION_COUNT
+    };
+
+    static const int BUCKET_COUNT = 8;
+
+    uint64_t operations[OPERATION_COUNT][BUCKET_COUNT];
+    uint64_t allocations;      // выделения памяти под лимбы
+    uint64_t allocatedBytes;   // суммарный объем выделенной памяти
+    uint64_t temporaries;      // созданные объекты BigInt (включая копии)
+
+    BigIntStatsSnapshot() : allocations(0), allocatedBytes(0), temporaries(0) {
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+            for (int b = 0; b < BUCKET_COUNT; ++b)
+                operations[op][b] = 0;
+    }
+
+    uint64_t total(Operation op) const {
+        uint64_t sum = 0;
+        for (int b = 0; b < BUCKET_COUNT; ++b)
+            sum += operations[op][b];
+        return sum;
+    }
+
+    static const char* operationName(Operation op) {
+        static const char* const names[OPERATION_COUNT] = {
+            "add", "sub", "mul", "div", "mod", "pow", "modPow", "gcd", "sqrt"
+        };
+        return names[op];
+    }
+
+    // Верхняя граница корзины в цифрах (0 - последняя корзина без границы)
+    static size_t bucketLimit(int bucket) {
+        static const size_t limits[BUCKET_COUNT - 1] = {20, 39, 78, 155, 309, 617, 1234};
+        return bucket < BUCKET_COUNT - 1 ? limits[bucket] : 0;
+    }
+
+    static int bucketFor(size_t digits) {
+        int bucket = 0;
+        while (bucket < BUCKET_COUNT - 1 && digits > bucketLimit(bucket))
+            ++bucket;
+        return bucket;
+    }
+
+    // Десятичных цифр в числе из bits бит (для ядра на двоичных лимбах)
+    static size_t digitsForBits(size_t bits) {
+        return bits * 30103 / 100000 + 1;
+    }
+};
+
+// Сбор и вывод счетчиков
+class BigIntStats {
+    struct Counters {
+        std::atomic<uint64_t> operations[BigIntStatsSnapshot::OPERATION_COUNT][BigIntStatsSnapshot::BUCKET_COUNT];
+        std::atomic<uint64_t> allocations, allocatedBytes, temporaries;
+    };
+
+    // Статическая память обнуляется до первого обращения
+    static Counters& counters() {
+        static Counters instance;
+        return instance;
+    }
+
+    // Глубина вложенности учитываемых операций в текущем потоке
+    static int& depth() {
+        static thread_local int value = 0;
+        return value;
+    }
+
+public:
+    static bool enabled() {
+#ifdef BIGINT_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static BigIntStatsSnapshot snapshot() {
+        Counters& c = counters();
+        BigIntStatsSnapshot stats;
+        for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op)
+            for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b)
+                stats.operations[op][b] = c.operations[op][b].load(std::memory_order_relaxed);
+        stats.allocations = c.allocations.load(std::memory_order_relaxed);
+        stats.allocatedBytes = c.allocatedBytes.load(std::memory_order_relaxed);
+        stats.temporaries = c.temporaries.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    static void reset() {
+        Counters& c = counters();
+        for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op)
+            for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b)
+                c.operations[op][b].store(0, std::memory_order_relaxed);
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.allocatedBytes.store(0, std::memory_order_relaxed);
+        c.temporaries.store(0, std::memory_order_relaxed);
+    }
+
+    // Точки учета, вызываются из арифметического ядра через макросы ниже
+    static void countAllocation(size_t bytes) {
+        counters().allocations.fetch_add(1, std::memory_order_relaxed);
+        counters().allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    static void countTemporary() {
+        counters().temporaries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Учитывает операцию, если она не вложена в другую учитываемую операцию
+    class Scope {
+    public:
+        Scope(BigIntStatsSnapshot::Operation op, size_t digits) {
+            if (depth()++ == 0)
+                counters().operations[op][BigIntStatsSnapshot::bucketFor(digits)].fetch_add(1, std::memory_order_relaxed);
+        }
+        ~Scope() { --depth(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Ненулевые счетчики в виде таблицы
+    static void print(std::ostream& os, const BigIntStatsSnapshot& stats) {
+        os << "------------------------------------------" << std::endl;
+        os << "СЧЕТЧИКИ ОПЕРАЦИЙ BigInt" << std::endl;
+        os << "------------------------------------------" << std::endl;
+        if (!enabled()) {
+            os << "Счетчики отключены (сборка без BIGINT_STATS)" << std::endl;
+            return;
+        }
+
+        // Заголовок: верхние границы корзин в цифрах
+        os << std::setw(8) << " ";
+        for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b) {
+            size_t limit = BigIntStatsSnapshot::bucketLimit(b);
+            std::string label = limit ? "<=" + std::to_string(limit)
+                                      : ">" + std::to_string(BigIntStatsSnapshot::bucketLimit(b - 1));
+            os << std::setw(11) << label;
+        }
+        os << std::setw(12) << "total" << std::endl;
+
+        for (int op = 0; op < BigIntStatsSnapshot::OPERATION_COUNT; ++op) {
+            BigIntStatsSnapshot::Operation operation = static_cast<BigIntStatsSnapshot::Operation>(op);
+            uint64_t total = stats.total(operation);
+            if (total == 0) continue;
+            os << std::setw(8) << BigIntStatsSnapshot::operationName(operation);
+            for (int b = 0; b < BigIntStatsSnapshot::BUCKET_COUNT; ++b)
+                os << std::setw(11) << stats.operations[op][b];
+            os << std::setw(12) << total << std::endl;
+        }
+
+        os << "Выделений памяти: " << stats.allocations
+           << " (" << stats.allocatedBytes << " байт)" << std::endl;
+        os << "Созданных объектов BigInt: " << stats.temporaries << std::endl;
+    }
+
+    static void print(std::ostream& os = std::cout) {
+        print(os, snapshot());
+    }
+};
+
+#ifdef BIGINT_STATS
+
+#define BIGINT_STATS_CONCAT_(a, b) a##b
+#define BIGINT_STATS_CONCAT(a, b) BIGINT_STATS_CONCAT_(a, b)
+#define BIGINT_STATS_OPERATION(op, digits) \
+    BigIntStats::Scope BIGINT_STATS_CONCAT(bigintStatsScope, __LINE__)(BigIntStatsSnapshot::op, (digits))
+#define BIGINT_STATS_TEMPORARY() BigIntStats::countTemporary()
+#define BIGINT_STATS_ALLOCATION(bytes) BigIntStats::countAllocation(bytes)
+
+// Аллокатор для лимбов собственного ядра, учитывающий выделения памяти
+template <typename T>
+struct BigIntStatsAllocator {
+    typedef T value_type;
+
+    BigIntStatsAllocator() = default;
+    template <typename U>
+    BigIntStatsAllocator(const BigIntStatsAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        BigIntStats::countAllocation(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const BigIntStatsAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const BigIntStatsAllocator<U>&) const { return false; }
+};
+
+#else
+
+#define BIGINT_STATS_OPERATION(op, digits) ((void)0)
+#define BIGINT_STATS_TEMPORARY() ((void)0)
+#define BIGINT_STATS_ALLOCATION(bytes) ((void)0)
+
+#endif
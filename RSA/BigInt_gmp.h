@@ -0,0 +1,397 @@
+#pragma once
+// Класс BigInt на mpz_class (GMP) с тем же интерфейсом, что и десятичный BigInt
+// из BigInt.h. Подключается из BigInt.h при компиляции с -DBIGINT_BACKEND_GMP.
+// Семантика сохранена: числа неотрицательные, вычитание большего из меньшего
+// и декремент нуля бросают "UNDERFLOW", ошибки разбора - "ERROR".
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <string>
+#include <cctype>
+#include <algorithm>
+#include <gmpxx.h>
+using namespace std;
+
+class BigInt {
+    mpz_class value;
+public:
+    // Размер большего операнда в десятичных цифрах для счетчиков BigIntStats
+    // (ядро, ModExp_*, НОД; оценка GMP, может быть больше на 1)
+    static size_t statsDigits(const BigInt& a, const BigInt& b) {
+        return max(mpz_sizeinbase(a.value.get_mpz_t(), 10), mpz_sizeinbase(b.value.get_mpz_t(), 10));
+    }
+
+    // Constructors:
+    BigInt(unsigned long long n = 0);
+    BigInt(const std::string&);
+    BigInt(const char*);
+    BigInt(const BigInt&);
+
+    // Helper Functions:
+    friend void divide_by_2(BigInt& a);
+    friend bool Null(const BigInt&);
+    friend int Length(const BigInt&);
+    int operator[](const int)const;
+
+    // Byte import/export (unsigned, no leading zero bytes; 0 <-> empty)
+    static BigInt fromBytes(const uint8_t* data, size_t length, ByteOrder order = ByteOrder::BigEndian);
+    std::vector<uint8_t> toBytes(ByteOrder order = ByteOrder::BigEndian) const;
+
+    /* * * * Operator Overloading * * * */
+    // Direct assignment
+    BigInt& operator=(const BigInt&);
+
+    // Post/Pre - Incrementation
+    BigInt& operator++();
+    BigInt operator++(int temp);
+    BigInt& operator--();
+    BigInt operator--(int temp);
+
+    // Addition and Subtraction
+    friend BigInt& operator+=(BigInt&, const BigInt&);
+    friend BigInt operator+(const BigInt&, const BigInt&);
+    friend BigInt operator-(const BigInt&, const BigInt&);
+    friend BigInt& operator-=(BigInt&, const BigInt&);
+
+    // Comparison operators
+    friend bool operator==(const BigInt&, const BigInt&);
+    friend bool operator!=(const BigInt&, const BigInt&);
+    friend bool operator>(const BigInt&, const BigInt&);
+    friend bool operator>=(const BigInt&, const BigInt&);
+    friend bool operator<(const BigInt&, const BigInt&);
+    friend bool operator<=(const BigInt&, const BigInt&);
+
+    // Multiplication and Division
+    friend BigInt& operator*=(BigInt&, const BigInt&);
+    friend BigInt operator*(const BigInt&, const BigInt&);
+    friend BigInt& operator/=(BigInt&, const BigInt&);
+    friend BigInt operator/(const BigInt&, const BigInt&);
+
+    // Modulo
+    friend BigInt operator%(const BigInt&, const BigInt&);
+    friend BigInt& operator%=(BigInt&, const BigInt&);
+
+    // Power Function
+    friend BigInt& operator^=(BigInt&, const BigInt&);
+    friend BigInt operator^(BigInt&, const BigInt&);
+
+    // Square Root Function
+    friend BigInt sqrt(BigInt& a);
+
+    // Read and Write
+    friend ostream& operator<<(ostream&, const BigInt&);
+    friend istream& operator>>(istream&, BigInt&);
+
+    // Others
+    BigInt NthCatalan(int n) {
+        BigInt a(1), b;
+        for (int i = 2; i <= n; i++)
+            a *= i;
+        b = a;
+        for (int i = n + 1; i <= 2 * n; i++)
+            b *= i;
+        a *= a;
+        a *= (n + 1);
+        b /= a;
+        return b;
+    }
+
+    BigInt NthFibonacci(int n) {
+        BigInt a(1), b(1), c;
+        if (!n)
+            return c;
+        n--;
+        while (n--) {
+            c = a + b;
+            b = a;
+            a = c;
+        }
+        return b;
+    }
+
+    BigInt Factorial(int n) {
+        BigInt f(1);
+        for (int i = 2; i <= n; i++)
+            f *= i;
+        return f;
+    }
+
+    // Helper function to convert to int (for testing)
+    int to_int() const {
+        return static_cast<int>(value.get_si());
+    }
+};
+
+// Разбор десятичной строки без знака
+inline void ParseDecimal(mpz_class& out, const char* s, size_t len, const char* error) {
+    if (len == 0) {
+        out = 0;
+        return;
+    }
+    for (size_t i = 0; i < len; i++)
+        if (!isdigit((unsigned char)s[i]))
+            throw(error);
+    out.set_str(std::string(s, len), 10);
+}
+
+#ifdef BIGINT_STATS
+// Учет выделений памяти GMP: обертки над функциями, установленными по умолчанию.
+// Считаются все выделения mpz в процессе, не только внутри BigInt
+struct BigIntGmpMemory {
+    void* (*allocate)(size_t);
+    void* (*reallocate)(void*, size_t, size_t);
+    void (*release)(void*, size_t);
+
+    static void* countingAllocate(size_t size) {
+        BIGINT_STATS_ALLOCATION(size);
+        return defaults().allocate(size);
+    }
+
+    static void* countingReallocate(void* ptr, size_t oldSize, size_t newSize) {
+        BIGINT_STATS_ALLOCATION(newSize);
+        return defaults().reallocate(ptr, oldSize, newSize);
+    }
+
+    // Функции GMP по умолчанию; при первом обращении вместо них ставятся обертки
+    static BigIntGmpMemory& defaults() {
+        static BigIntGmpMemory memory = install();
+        return memory;
+    }
+
+    static BigIntGmpMemory install() {
+        BigIntGmpMemory memory;
+        mp_get_memory_functions(&memory.allocate, &memory.reallocate, &memory.release);
+        mp_set_memory_functions(countingAllocate, countingReallocate, memory.release);
+        return memory;
+    }
+};
+
+// Обертки ставятся при запуске программы, до первых вычислений
+static BigIntGmpMemory& bigintGmpMemory = BigIntGmpMemory::defaults();
+#endif
+
+// Constructor implementations
+inline BigInt::BigInt(const std::string& s) {
+    BIGINT_STATS_TEMPORARY();
+    ParseDecimal(value, s.data(), s.size(), "ERROR");
+}
+
+inline BigInt::BigInt(unsigned long long nr) {
+    BIGINT_STATS_TEMPORARY();
+    mpz_import(value.get_mpz_t(), 1, -1, sizeof(nr), 0, 0, &nr);
+}
+
+inline BigInt::BigInt(const char* s) {
+    BIGINT_STATS_TEMPORARY();
+    ParseDecimal(value, s, strlen(s), "ERROR");
+}
+
+inline BigInt::BigInt(const BigInt& a) : value(a.value) {
+    BIGINT_STATS_TEMPORARY();
+}
+
+inline BigInt BigInt::fromBytes(const uint8_t* data, size_t length, ByteOrder order) {
+    BigInt result;
+    mpz_import(result.value.get_mpz_t(), length, order == ByteOrder::BigEndian ? 1 : -1, 1, 0, 0, data);
+    return result;
+}
+
+inline std::vector<uint8_t> BigInt::toBytes(ByteOrder order) const {
+    std::vector<uint8_t> bytes;
+    if (sgn(value) == 0)
+        return bytes;
+    bytes.resize((mpz_sizeinbase(value.get_mpz_t(), 2) + 7) / 8);
+    size_t written = 0;
+    mpz_export(bytes.data(), &written, order == ByteOrder::BigEndian ? 1 : -1, 1, 0, 0, value.get_mpz_t());
+    bytes.resize(written);
+    return bytes;
+}
+
+inline bool Null(const BigInt& a) {
+    return sgn(a.value) == 0;
+}
+
+inline int Length(const BigInt& a) {
+    // mpz_sizeinbase может завысить результат на единицу
+    size_t len = mpz_sizeinbase(a.value.get_mpz_t(), 10);
+    if (len > 1) {
+        mpz_class lower;
+        mpz_ui_pow_ui(lower.get_mpz_t(), 10, len - 1);
+        if (a.value < lower)
+            len--;
+    }
+    return (int)len;
+}
+
+inline int BigInt::operator[](const int index)const {
+    if (Length(*this) <= index || index < 0)
+        throw("ERROR");
+    if (index == 0)
+        return (int)mpz_fdiv_ui(value.get_mpz_t(), 10);
+    mpz_class shifted, power;
+    mpz_ui_pow_ui(power.get_mpz_t(), 10, index);
+    mpz_fdiv_q(shifted.get_mpz_t(), value.get_mpz_t(), power.get_mpz_t());
+    return (int)mpz_fdiv_ui(shifted.get_mpz_t(), 10);
+}
+
+inline bool operator==(const BigInt& a, const BigInt& b) {
+    return a.value == b.value;
+}
+
+inline bool operator!=(const BigInt& a, const BigInt& b) {
+    return !(a == b);
+}
+
+inline bool operator<(const BigInt& a, const BigInt& b) {
+    return a.value < b.value;
+}
+
+inline bool operator>(const BigInt& a, const BigInt& b) {
+    return b < a;
+}
+
+inline bool operator>=(const BigInt& a, const BigInt& b) {
+    return !(a < b);
+}
+
+inline bool operator<=(const BigInt& a, const BigInt& b) {
+    return !(a > b);
+}
+
+inline BigInt& BigInt::operator=(const BigInt& a) {
+    value = a.value;
+    return *this;
+}
+
+inline BigInt& BigInt::operator++() {
+    ++value;
+    return *this;
+}
+
+inline BigInt BigInt::operator++(int temp) {
+    BigInt aux;
+    aux = *this;
+    ++(*this);
+    return aux;
+}
+
+inline BigInt& BigInt::operator--() {
+    if (sgn(value) == 0)
+        throw("UNDERFLOW");
+    --value;
+    return *this;
+}
+
+inline BigInt BigInt::operator--(int temp) {
+    BigInt aux;
+    aux = *this;
+    --(*this);
+    return aux;
+}
+
+inline BigInt& operator+=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(ADD, BigInt::statsDigits(a, b));
+    a.value += b.value;
+    return a;
+}
+
+inline BigInt operator+(const BigInt& a, const BigInt& b) {
+    BigInt temp;
+    temp = a;
+    temp += b;
+    return temp;
+}
+
+inline BigInt& operator-=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(SUB, BigInt::statsDigits(a, b));
+    if (a < b)
+        throw("UNDERFLOW");
+    a.value -= b.value;
+    return a;
+}
+
+inline BigInt operator-(const BigInt& a, const BigInt& b) {
+    BigInt temp;
+    temp = a;
+    temp -= b;
+    return temp;
+}
+
+inline BigInt& operator*=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(MUL, BigInt::statsDigits(a, b));
+    a.value *= b.value;
+    return a;
+}
+
+inline BigInt operator*(const BigInt& a, const BigInt& b) {
+    BigInt temp;
+    temp = a;
+    temp *= b;
+    return temp;
+}
+
+inline BigInt& operator/=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(DIV, BigInt::statsDigits(a, b));
+    if (Null(b))
+        throw("Arithmetic Error: Division By 0");
+    mpz_fdiv_q(a.value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_mpz_t());
+    return a;
+}
+
+inline BigInt operator/(const BigInt& a, const BigInt& b) {
+    BigInt temp;
+    temp = a;
+    temp /= b;
+    return temp;
+}
+
+inline BigInt& operator%=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(MOD, BigInt::statsDigits(a, b));
+    if (Null(b))
+        throw("Arithmetic Error: Division By 0");
+    mpz_fdiv_r(a.value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_mpz_t());
+    return a;
+}
+
+inline BigInt operator%(const BigInt& a, const BigInt& b) {
+    BigInt temp;
+    temp = a;
+    temp %= b;
+    return temp;
+}
+
+inline BigInt& operator^=(BigInt& a, const BigInt& b) {
+    BIGINT_STATS_OPERATION(POW, BigInt::statsDigits(a, a));
+    if (!b.value.fits_ulong_p())
+        throw("OVERFLOW");
+    mpz_pow_ui(a.value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_ui());
+    return a;
+}
+
+inline BigInt operator^(BigInt& a, const BigInt& b) {
+    BigInt temp(a);
+    temp ^= b;
+    return temp;
+}
+
+inline void divide_by_2(BigInt& a) {
+    mpz_fdiv_q_2exp(a.value.get_mpz_t(), a.value.get_mpz_t(), 1);
+}
+
+inline BigInt sqrt(BigInt& a) {
+    BIGINT_STATS_OPERATION(SQRT, BigInt::statsDigits(a, a));
+    BigInt v;
+    mpz_sqrt(v.value.get_mpz_t(), a.value.get_mpz_t());
+    return v;
+}
+
+inline istream& operator>>(istream& in, BigInt& a) {
+    std::string s; in >> s;
+    ParseDecimal(a.value, s.data(), s.size(), "INVALID NUMBER");
+    return in;
+}
+
+inline ostream& operator<<(ostream& out, const BigInt& a) {
+    out << a.value.get_str(10);
+    return out;
+}
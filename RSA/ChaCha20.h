@@ -0,0 +1,170 @@
+#pragma once
+// Потоковый шифр ChaCha20 (RFC 8439): 256-битный ключ, 96-битный nonce,
+// 32-битный счётчик блоков по 64 байта. Один nonce даёт не больше
+// 2^32 блоков (256 ГиБ) гаммы: дальше счётчик обернулся бы и гамма
+// повторилась, поэтому apply бросает исключение раньше.
+// На x86-64 четыре блока считаются одновременно в регистрах SSE2
+// (слово состояния i всех четырёх блоков лежит в одном __m128i).
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+class ChaCha20 {
+    uint32_t state[16];
+    uint8_t keystream[256];  // До четырёх блоков гаммы
+    size_t used;             // Использовано байт из keystream
+    size_t available;        // Всего байт в keystream
+    uint64_t blocksLeft;     // Блоков до переполнения счётчика state[12]
+
+    static uint32_t load32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    static void store32(uint8_t* p, uint32_t v) {
+        p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+    }
+
+    static uint32_t rotl(uint32_t v, int n) {
+        return (v << n) | (v >> (32 - n));
+    }
+
+    static void quarterRound(uint32_t* x, int a, int b, int c, int d) {
+        x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16);
+        x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12);
+        x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 8);
+        x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 7);
+    }
+
+    // Списывает blocks блоков гаммы до оборота 32-битного счётчика
+    void reserve(uint64_t blocks) {
+        if (blocksLeft < blocks)
+            throw("Error: ChaCha20 block counter exhausted for this nonce");
+        blocksLeft -= blocks;
+    }
+
+    // Один блок гаммы для текущего счётчика
+    void block(uint8_t* out) {
+        reserve(1);
+        uint32_t x[16];
+        memcpy(x, state, sizeof(x));
+        for (int i = 0; i < 10; ++i) {
+            quarterRound(x, 0, 4, 8, 12); quarterRound(x, 1, 5, 9, 13);
+            quarterRound(x, 2, 6, 10, 14); quarterRound(x, 3, 7, 11, 15);
+            quarterRound(x, 0, 5, 10, 15); quarterRound(x, 1, 6, 11, 12);
+            quarterRound(x, 2, 7, 8, 13); quarterRound(x, 3, 4, 9, 14);
+        }
+        for (int i = 0; i < 16; ++i)
+            store32(out + 4 * i, x[i] + state[i]);
+        ++state[12];
+    }
+
+#if defined(__SSE2__)
+    static __m128i rotl4(__m128i v, int n) {
+        return _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - n));
+    }
+
+    static void quarterRound4(__m128i* x, int a, int b, int c, int d) {
+        x[a] = _mm_add_epi32(x[a], x[b]); x[d] = rotl4(_mm_xor_si128(x[d], x[a]), 16);
+        x[c] = _mm_add_epi32(x[c], x[d]); x[b] = rotl4(_mm_xor_si128(x[b], x[c]), 12);
+        x[a] = _mm_add_epi32(x[a], x[b]); x[d] = rotl4(_mm_xor_si128(x[d], x[a]), 8);
+        x[c] = _mm_add_epi32(x[c], x[d]); x[b] = rotl4(_mm_xor_si128(x[b], x[c]), 7);
+    }
+
+    // Четыре блока гаммы (счётчики state[12] .. state[12] + 3).
+    // combine = true: гамма накладывается на 256 байт out, иначе записывается в out
+    void block4(uint8_t* out, bool combine) {
+        reserve(4);
+        __m128i x[16], initial[16];
+        for (int i = 0; i < 16; ++i)
+            initial[i] = _mm_set1_epi32((int)state[i]);
+        initial[12] = _mm_add_epi32(initial[12], _mm_set_epi32(3, 2, 1, 0));
+        for (int i = 0; i < 16; ++i)
+            x[i] = initial[i];
+        for (int i = 0; i < 10; ++i) {
+            quarterRound4(x, 0, 4, 8, 12); quarterRound4(x, 1, 5, 9, 13);
+            quarterRound4(x, 2, 6, 10, 14); quarterRound4(x, 3, 7, 11, 15);
+            quarterRound4(x, 0, 5, 10, 15); quarterRound4(x, 1, 6, 11, 12);
+            quarterRound4(x, 2, 7, 8, 13); quarterRound4(x, 3, 4, 9, 14);
+        }
+        // Транспонирование 4x4: слова i..i+3 блока j -> out[64 * j + 4 * i]
+        // (SSE2 есть только на little-endian x86, порядок байт совпадает с RFC)
+        for (int i = 0; i < 16; i += 4) {
+            __m128i a0 = _mm_add_epi32(x[i], initial[i]), a1 = _mm_add_epi32(x[i + 1], initial[i + 1]);
+            __m128i a2 = _mm_add_epi32(x[i + 2], initial[i + 2]), a3 = _mm_add_epi32(x[i + 3], initial[i + 3]);
+            __m128i t0 = _mm_unpacklo_epi32(a0, a1), t1 = _mm_unpacklo_epi32(a2, a3);
+            __m128i t2 = _mm_unpackhi_epi32(a0, a1), t3 = _mm_unpackhi_epi32(a2, a3);
+            __m128i rows[4] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                               _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+            for (int j = 0; j < 4; ++j) {
+                __m128i* p = reinterpret_cast<__m128i*>(out + 64 * j + 4 * i);
+                _mm_storeu_si128(p, combine ? _mm_xor_si128(rows[j], _mm_loadu_si128(p)) : rows[j]);
+            }
+        }
+        state[12] += 4;
+    }
+#endif
+
+    void refill() {
+#if defined(__SSE2__)
+        // У самого конца счётчика - по одному блоку
+        if (blocksLeft >= 4) {
+            block4(keystream, false);
+            available = 256;
+            used = 0;
+            return;
+        }
+#endif
+        block(keystream);
+        available = 64;
+        used = 0;
+    }
+
+public:
+    ChaCha20(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter = 0)
+        : used(0), available(0), blocksLeft((1ull << 32) - counter) {
+        state[0] = 0x61707865; state[1] = 0x3320646e; state[2] = 0x79622d32; state[3] = 0x6b206574;
+        for (int i = 0; i < 8; ++i)
+            state[4 + i] = load32(key + 4 * i);
+        state[12] = counter;
+        for (int i = 0; i < 3; ++i)
+            state[13 + i] = load32(nonce + 4 * i);
+    }
+
+    ~ChaCha20() {
+        // Ключ и гамма не остаются в памяти после использования
+        volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(this);
+        for (size_t i = 0; i < sizeof(*this); ++i)
+            p[i] = 0;
+    }
+
+    ChaCha20(const ChaCha20&) = delete;
+    ChaCha20& operator=(const ChaCha20&) = delete;
+
+    // XOR данных с гаммой; шифрование и расшифровка совпадают.
+    // Можно вызывать по частям любой длины - гамма продолжается
+    void apply(uint8_t* data, size_t size) {
+        while (size > 0) {
+#if defined(__SSE2__)
+            // Целые четвёрки блоков шифруются на месте, без буфера гаммы
+            if (used == available && size >= 256 && blocksLeft >= 4) {
+                block4(data, true);
+                data += 256;
+                size -= 256;
+                continue;
+            }
+#endif
+            if (used == available) refill();
+            size_t count = available - used;
+            if (count > size) count = size;
+            for (size_t i = 0; i < count; ++i)
+                data[i] ^= keystream[used + i];
+            used += count;
+            data += count;
+            size -= count;
+        }
+    }
+};
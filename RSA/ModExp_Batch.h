@@ -0,0 +1,135 @@
+#pragma once
+// Пакетное модульное возведение в степень в дорожках Монтгомери.
+//
+// Независимые возведения с модулями одной длины (половинки CRT всех блоков
+// сообщения, свидетели одного числа) идут группами по MODEXP_LANES.
+// Числа переводятся в 32-битные лимбы; лимб j дорожки l хранится в элементе
+// j * MODEXP_LANES + l, поэтому внутренний цикл умножения Монтгомери
+// выполняет одинаковые операции над всеми дорожками и векторизуется
+// компилятором (64-битные произведения 32-битных лимбов: pmuludq / vpmuludq).
+// Арифметика BigInt при этом не используется вовсе. Ядро дорожек -
+// MontgomeryLanes из common/montgomery_lanes.h, общее с PZ_3.
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "Prime.h"
+#include "montgomery_lanes.h"
+#include "trace.h"
+
+const int MODEXP_LANES = MontgomeryLanes::LANES;
+
+typedef MontgomeryLanes::Limbs ModExpLimbs;  // младший лимб первым
+typedef MontgomeryLanes::Modulus ModExpModulus;  // Лимбы, n0inv и R^2 mod n модуля
+
+// BigInt -> лимбы (число неотрицательное)
+inline ModExpLimbs ModExp_ToLimbs(const BigInt& x) {
+    const std::vector<uint8_t> bytes = x.toBytes(ByteOrder::LittleEndian);
+    ModExpLimbs limbs((bytes.size() + 3) / 4, 0);
+    for (size_t i = 0; i < bytes.size(); ++i)
+        limbs[i / 4] |= (uint32_t)bytes[i] << (8 * (i % 4));
+    while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+    return limbs;
+}
+
+inline BigInt ModExp_FromLimbs(const ModExpLimbs& limbs) {
+    std::vector<uint8_t> bytes(limbs.size() * 4);
+    for (size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = (uint8_t)(limbs[i / 4] >> (8 * (i % 4)));
+    return BigInt::fromBytes(bytes.data(), bytes.size(), ByteOrder::LittleEndian);
+}
+
+// Постоянные Монтгомери нечётного модуля > 1: считаются один раз
+// (при загрузке ключа) и служат всем возведениям по нему
+inline ModExpModulus ModExp_PrepareModulus(const BigInt& mod) {
+    return ModExpModulus(ModExp_ToLimbs(mod));
+}
+
+// results[i] = bases[i]^exps[i] mod mods[i] по подготовленным модулям,
+// bases[i] < mods[i]. Возведения с модулями одной длины идут группами
+// по MODEXP_LANES, неполная группа дополняется копиями первой дорожки
+inline std::vector<BigInt> ModExp_Batch_Prepared(const std::vector<BigInt>& bases,
+                                                 const std::vector<const ModExpLimbs*>& exps,
+                                                 const std::vector<const ModExpModulus*>& mods) {
+    TRACE_SPAN("modExp.batch", "rsa");
+    if (bases.size() != mods.size() || exps.size() != mods.size())
+        throw("Error: ModExp_Batch_Prepared operand counts differ");
+
+    std::vector<BigInt> results(mods.size());
+    std::vector<ModExpLimbs> limbBases(mods.size());
+    std::map<size_t, std::vector<size_t> > groups;  // длина модуля -> индексы
+    for (size_t i = 0; i < mods.size(); ++i) {
+        limbBases[i] = ModExp_ToLimbs(bases[i]);
+        groups[mods[i]->size()].push_back(i);
+    }
+
+    for (std::map<size_t, std::vector<size_t> >::const_iterator g = groups.begin(); g != groups.end(); ++g) {
+        const std::vector<size_t>& indices = g->second;
+        for (size_t first = 0; first < indices.size(); first += MODEXP_LANES) {
+            const ModExpLimbs* laneBases[MODEXP_LANES];
+            const ModExpLimbs* laneExps[MODEXP_LANES];
+            const ModExpModulus* laneMods[MODEXP_LANES];
+            for (int l = 0; l < MODEXP_LANES; ++l) {
+                size_t i = indices[first + l < indices.size() ? first + l : first];
+                laneBases[l] = &limbBases[i];
+                laneExps[l] = exps[i];
+                laneMods[l] = mods[i];
+            }
+            std::vector<ModExpLimbs> laneResults;
+            MontgomeryLanes::modPow(laneBases, laneExps, laneMods, laneResults);
+            for (int l = 0; l < MODEXP_LANES && first + l < indices.size(); ++l)
+                results[indices[first + l]] = ModExp_FromLimbs(laneResults[l]);
+        }
+    }
+    return results;
+}
+
+// Возведение по битам показателя для модулей, не подходящих для дорожек
+inline BigInt ModExp_Binary(const BigInt& base, const ModExpLimbs& exp, const BigInt& mod) {
+    BIGINT_STATS_OPERATION(MODPOW, BigInt::statsDigits(base, mod));
+    BigInt result("1"), b = base % mod;
+    for (size_t bit = exp.size() * 32; bit-- > 0;) {
+        result = (result * result) % mod;
+        if ((exp[bit / 32] >> (bit % 32)) & 1)
+            result = (result * b) % mod;
+    }
+    return result % mod;
+}
+
+// results[i] = bases[i]^exps[i] mod mods[i].
+// Нечётные модули > 1 идут в дорожки (постоянные Монтгомери - по одному разу
+// на различный модуль), остальные - через ModExp_Binary
+inline std::vector<BigInt> ModExp_Batch_Lanes(const std::vector<BigInt>& bases,
+                                              const std::vector<BigInt>& exps,
+                                              const std::vector<BigInt>& mods) {
+    if (bases.size() != mods.size() || exps.size() != mods.size())
+        throw("Error: ModExp_Batch_Lanes operand counts differ");
+
+    std::vector<BigInt> results(mods.size());
+    std::vector<ModExpLimbs> limbExps(mods.size());
+    std::map<ModExpLimbs, ModExpModulus> prepared;
+    std::vector<size_t> indices;
+    std::vector<BigInt> laneBases;
+    std::vector<const ModExpLimbs*> laneExps;
+    std::vector<const ModExpModulus*> laneMods;
+    const BigInt one("1");
+    for (size_t i = 0; i < mods.size(); ++i) {
+        limbExps[i] = ModExp_ToLimbs(exps[i]);
+        const ModExpLimbs limbMod = ModExp_ToLimbs(mods[i]);
+        if (mods[i] <= one || (limbMod[0] & 1) == 0) {
+            results[i] = ModExp_Binary(bases[i], limbExps[i], mods[i]);
+            continue;
+        }
+        std::map<ModExpLimbs, ModExpModulus>::iterator it = prepared.find(limbMod);
+        if (it == prepared.end())
+            it = prepared.insert(std::make_pair(limbMod, ModExpModulus(limbMod))).first;
+        indices.push_back(i);
+        laneBases.push_back(bases[i] < mods[i] ? bases[i] : bases[i] % mods[i]);
+        laneExps.push_back(&limbExps[i]);
+        laneMods.push_back(&it->second);
+    }
+
+    const std::vector<BigInt> powers = ModExp_Batch_Prepared(laneBases, laneExps, laneMods);
+    for (size_t k = 0; k < indices.size(); ++k)
+        results[indices[k]] = powers[k];
+    return results;
+}
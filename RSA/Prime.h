@@ -6,7 +6,15 @@
 #include <ctime>
 #include <cstdlib>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
 #include "BigInt.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -58,9 +66,8 @@ BigInt modulo(BigInt base, BigInt e, BigInt m) {
 	return result;
 }
 
-bool Check_1000_nums(BigInt p) {
-
-	BigInt mass_1000[1226] = { "7", "11", "13", "17", "8209", "19", "23", "8219", "29", "8221", "31", "37", "8231", "41", "8233", "43", "8237", "47",
+//    7  9973   
+const char* const mass_1000[1226] = { "7", "11", "13", "17", "8209", "19", "23", "8219", "29", "8221", "31", "37", "8231", "41", "8233", "43", "8237", "47",
 "8243", "53", "59", "61", "67", "71", "8263", "73", "8269", "79", "8273", "83", "89", "8287", "97", "8291", "101", "8293", "103", "8297",
 "107", "109", "113", "8311", "8317", "127", "131", "137", "8329", "139", "149", "151", "157", "8353", "163", "167", "8363", "173", "8369", "179",
 "181", "8377", "191", "193", "8387", "197", "8389", "199", "211", "223", "227", "8419", "229", "8423", "233", "8429", "239", "8431", "241", "251",
@@ -123,12 +130,64 @@ bool Check_1000_nums(BigInt p) {
 "7927", "7933", "7937", "7949", "7951", "7963", "7993", "8009", "8011", "8017", "8039", "8053", "8059", "8069", "8081", "8087", "8089", "8093", "8101", "8111",
 "8117", "8123", "8147", "8161", "8167", "8171", "8179", "8191" };
 
+//   mass_1000,     2^32.
+// P -   
+struct Small_Prime_Groups {
+	vector<uint32_t> primes;
+	vector<uint32_t> products;
+	vector<size_t> ends;		// ends[g] -   g  primes
+	BigInt P;
+
+	Small_Prime_Groups() : P(1) {
+		for (int i = 0; i < 1226; i++) {
+			primes.push_back((uint32_t)strtoul(mass_1000[i], nullptr, 10));
+		}
+		uint64_t product = 1;
+		for (size_t i = 0; i < primes.size(); i++) {
+			if (product * primes[i] > 0xFFFFFFFFULL) {
+				products.push_back((uint32_t)product);
+				ends.push_back(i);
+				product = 1;
+			}
+			product *= primes[i];
+		}
+		products.push_back((uint32_t)product);
+		ends.push_back(primes.size());
+		for (size_t g = 0; g < products.size(); g++) {
+			P *= BigInt(products[g]);
+		}
+	}
+};
+
+// 32-  ,  
+vector<uint32_t> Words_32(const BigInt& x) {
+	vector<uint8_t> bytes = x.toBytes(ByteOrder::LittleEndian);
+	vector<uint32_t> words((bytes.size() + 3) / 4, 0);
+	for (size_t i = 0; i < bytes.size(); i++) {
+		words[i / 4] |= (uint32_t)bytes[i] << (8 * (i % 4));
+	}
+	return words;
+}
+
+//      mass_1000    :
+// r = p mod P,   r      32-
+//  r,     -   
+bool Check_1000_nums(BigInt p) {
+	TRACE_SPAN("check_1000_nums", "prime");
+	static const Small_Prime_Groups groups;
 
+	vector<uint32_t> words = Words_32(p % groups.P);
 
-	for (int i = 0; i < 1226; i++) {
-		if (p % mass_1000[i] == "0") {
-			//cout << " Check 1000 false: " << mass_1000[i] << endl;
-			return false;
+	size_t i = 0;
+	for (size_t g = 0; g < groups.products.size(); g++) {
+		uint64_t rem = 0;
+		for (size_t j = words.size(); j-- > 0;) {
+			rem = ((rem << 32) | words[j]) % groups.products[g];
+		}
+		for (; i < groups.ends[g]; i++) {
+			if (rem % groups.primes[i] == 0) {
+				return false;
+			}
 		}
 	}
 
@@ -160,11 +219,33 @@ BigInt RandBigInt(BigInt p) {
 	return rand_num;
 }
 
+//     rng:        
+BigInt RandBigInt(BigInt p, mt19937_64& rng) {
+
+	int len = Length(p);
+	string nums;
+
+	nums += to_string(rng() % 9 + 1);
+	for (int i = 1; i < len; i++) {
+		nums += (rng() % 10) + 48;
+	}
+
+	// [2;p-2]
+	BigInt rand_num;
+	p -= "4";
+	rand_num = nums % p;
+	rand_num += "2";
+
+	return rand_num;
+}
 
 
-//     
-bool Miller(BigInt p, int iteration) {
-	srand(time(0));
+
+//     .
+//    rng; cancelled    ,
+//    false
+bool Miller(BigInt p, int iteration, mt19937_64& rng, const function<bool()>& cancelled) {
+	TRACE_SPAN("miller", "prime");
 
 	if (p < "2") {
 		return false;
@@ -185,8 +266,11 @@ bool Miller(BigInt p, int iteration) {
 	//cout << "interation: " << iteration << endl;
 	for (int i = 0; i < iteration; i++) {
 		//cout << "i: " << i << endl;
+		if (cancelled && cancelled()) {
+			return false;
+		}
 
-		BigInt a; a = RandBigInt(p);
+		BigInt a; a = RandBigInt(p, rng);
 		//cout << "a: " << a << endl;
 
 		BigInt temp = s;
@@ -203,10 +287,119 @@ bool Miller(BigInt p, int iteration) {
 	return true;
 }
 
+bool Miller(BigInt p, int iteration) {
+	mt19937_64 rng(random_device{}());
+	return Miller(p, iteration, rng, function<bool()>());
+}
+
+// log2   ,    k- ,
+//  t     , 
+// (Damgard, Landrock, Pomerance, 1993; k >= 21)
+double Miller_ErrorLog2(double k, int t) {
+	double log2k = log2(k);
+	double best = 0;
+	if (t == 1) {
+		best = min(best, 2 * log2k + 2 * (2 - sqrt(k)));
+	}
+	if ((t == 2 && k >= 88) || (t >= 3 && t <= k / 9)) {
+		best = min(best, 1.5 * log2k + t - 0.5 * log2((double)t) + 2 * (2 - sqrt(t * k)));
+	}
+	if (t >= k / 9 && t <= k / 4) {
+		double bound = 7.0 / 20 * k * exp2(-5.0 * t) +
+			1.0 / 7 * pow(k, 3.75) * exp2(-k / 2 - 2.0 * t) +
+			12 * k * exp2(-k / 4 - 3.0 * t);
+		best = min(best, log2(bound));
+	}
+	if (t >= k / 4) {
+		best = min(best, log2(1.0 / 7) + 3.75 * log2k - k / 2 - 2.0 * t);
+	}
+	return best;
+}
+
+//      bits-    2^-error_bits
+// (   FIPS 186: 1024  - 4 , 2048  - 2)
+int Miller_Rounds(int bits, int error_bits = 100) {
+	//           1/4
+	int worst_case = max(1, (error_bits + 1) / 2);
+	if (bits < 21) {
+		return worst_case;
+	}
+	for (int t = 1; t < worst_case; t++) {
+		if (Miller_ErrorLog2(bits, t) <= -error_bits) {
+			return t;
+		}
+	}
+	return worst_case;
+}
 
 
-//   
-BigInt search_prime(int bitness, BigInt& p, BigInt& q) {
+
+//   : 0 -   
+unsigned Search_Threads(unsigned threads) {
+	if (threads == 0) threads = thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+}
+
+//     k:   rng, cancelled -  
+typedef function<bool(uint64_t, mt19937_64&, const function<bool()>&)> Search_Test;
+
+//      0 .. count - 1.
+//   (threads = 0 -   )   
+//  ,      . 
+//  needed ,  test,    
+//  .  needed   
+//   ,     (, 
+//  ). on_found(k, n)   , n -  
+vector<uint64_t> Parallel_Search(uint64_t count, size_t needed, unsigned threads, const Search_Test& test,
+	const function<void(uint64_t, size_t)>& on_found, uint64_t& tested) {
+	atomic<uint64_t> next(0);
+	atomic<uint64_t> limit(count);	//  needed- 
+	atomic<uint64_t> checked(0);
+	mutex found_mutex;
+	set<uint64_t> found;
+
+	vector<thread> pool;
+	for (unsigned t = 0; t < Search_Threads(threads); ++t) {
+		pool.push_back(thread([&]() {
+			mt19937_64 rng(random_device{}());
+			for (uint64_t k = next++; k < limit; k = next++) {
+				bool passed = test(k, rng, [&]() { return k > limit; });
+				checked++;
+				if (passed) {
+					lock_guard<mutex> lock(found_mutex);
+					found.insert(k);
+					if (found.size() >= needed) {
+						set<uint64_t>::const_iterator last = found.begin();
+						advance(last, needed - 1);
+						limit = *last;
+					}
+					if (on_found) {
+						on_found(k, found.size());
+					}
+				}
+			}
+			}));
+	}
+	for (size_t t = 0; t < pool.size(); ++t) {
+		pool[t].join();
+	}
+
+	tested += checked;
+	vector<uint64_t> result(found.begin(), found.end());
+	if (result.size() > needed) {
+		result.resize(needed);
+	}
+	return result;
+}
+
+
+
+//     p < q  .
+//  6i-1, 6i+1      
+// (Parallel_Search); p  q -     ,
+//    
+BigInt search_prime(int bitness, BigInt& p, BigInt& q, unsigned threads = 0) {
+	TRACE_SPAN("search_prime", "prime");
 
 	// 
 	BigInt base_2("2");
@@ -220,63 +413,325 @@ BigInt search_prime(int bitness, BigInt& p, BigInt& q) {
 	cout << "end: " << end << endl;
 	cout << "len: " << Length(start) << endl;
 
-	//  
-	int count = 0;					// 
-	BigInt i; i = start / "6"; i++;	// 
-	BigInt start_i; start_i = i;
-	BigInt num_1;					//    
-	BigInt num_2;					//    
-	num_1 = "6" * i; num_1 = num_1 - "1";
-	num_2 = "6" * i; num_2 = num_2 + "1";
-
-	//cout << "i: " << i << endl;
-	// 
+	threads = Search_Threads(threads);
+
+	//    k: 6i - 1   k, 6i + 1  
+	BigInt start_i; start_i = start / "6"; start_i++;
+	auto candidate = [&](uint64_t k) {
+		BigInt num; num = "6" * (start_i + BigInt(k / 2));
+		if (k % 2 == 0) num -= "1";
+		else num += "1";
+		return num;
+	};
+	//   ,     [start, end]
+	const uint64_t count = bitness <= 64 ? (1ULL << (bitness - 1)) / 2 + 2 : ~0ULL;
+
+	const int rounds = Miller_Rounds(bitness);
+	uint64_t tested = 0;
+	auto started = chrono::steady_clock::now();
+	vector<uint64_t> found = Parallel_Search(count, 2, threads,
+		[&](uint64_t k, mt19937_64& rng, const function<bool()>& cancelled) {
+			TRACE_SPAN("search_prime.candidate", "prime");
+			BigInt num = candidate(k);
+			return num <= end && Miller(num, rounds, rng, cancelled);
+		},
+		[&](uint64_t k, size_t n) { cout << "count: " << n << " prime: " << candidate(k) << endl; },
+		tested);
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+	cout << "candidates: " << tested << ", threads: " << threads << ", rounds: " << rounds
+		<< ", candidates/s: " << (seconds > 0 ? tested / seconds : 0) << endl;
+
+	//     (   )
 	BigInt result;
+	if (found.size() > 0) {
+		p = candidate(found[0]);
+		result = p;
+	}
+	if (found.size() > 1) {
+		q = candidate(found[1]);
+		result = q;
+	}
+	return result;
+
+}
+
 
-	while (count < 2) {
-		cout << "num_1: " << num_1 << endl;
-		cout << "num_2: " << num_2 << endl;
-		int flag = 0;
-
-		thread t1([&]() {
-			if (Miller(num_1, 100)) {
-				result = num_1;
-				flag = 1;
-				count++;
-				//cout << "prime: " << num_1 << endl;
+
+//   3  9973  
+const vector<uint32_t>& Sieve_Primes() {
+	static const vector<uint32_t> primes = []() {
+		vector<uint32_t> result = { 3, 5 };
+		for (int i = 0; i < 1226; i++) {
+			result.push_back((uint32_t)strtoul(mass_1000[i], nullptr, 10));
+		}
+		return result;
+	}();
+	return primes;
+}
+
+//     :      
+vector<uint32_t> Sieve_Residues(const BigInt& x) {
+	const vector<uint32_t>& primes = Sieve_Primes();
+	vector<uint32_t> words = Words_32(x);
+	vector<uint32_t> residues(primes.size());
+	for (size_t i = 0; i < primes.size(); i++) {
+		uint64_t rem = 0;
+		for (size_t j = words.size(); j-- > 0;) {
+			rem = ((rem << 32) | words[j]) % primes[i];
+		}
+		residues[i] = (uint32_t)rem;
+	}
+	return residues;
+}
+
+//   d    r (  )
+uint64_t Sieve_Inverse(uint64_t d, uint64_t r) {
+	uint64_t result = 1;
+	for (uint64_t e = r - 2; e > 0; e >>= 1) {
+		if (e & 1) result = result * d % r;
+		d = d * d % r;
+	}
+	return result;
+}
+
+//   a + d * k:  a  d   
+struct Sieve_Form {
+	vector<uint32_t> a;
+	vector<uint32_t> d;
+
+	Sieve_Form(const BigInt& a_num, const BigInt& d_num) : a(Sieve_Residues(a_num)), d(Sieve_Residues(d_num)) {}
+};
+
+//    :  k  [first, first + count) ,
+//      a + d * k  forms      3  9973.
+//      9973
+vector<uint64_t> Sieve_Forms(const vector<Sieve_Form>& forms, uint64_t first, size_t count) {
+	TRACE_SPAN("sieve_forms", "prime");
+	const vector<uint32_t>& primes = Sieve_Primes();
+	vector<char> composite(count, 0);
+	for (size_t f = 0; f < forms.size(); f++) {
+		for (size_t i = 0; i < primes.size(); i++) {
+			const uint64_t r = primes[i];
+			const uint64_t a = forms[f].a[i], d = forms[f].d[i];
+			if (d == 0) {
+				//      
+				if (a == 0) fill(composite.begin(), composite.end(), 1);
+				continue;
 			}
-			});
-		thread t2([&]() {
-			if (Miller(num_2, 100)) {
-				result = num_2;
-				flag = 1;
-				count++;
-				//cout << "prime: " << num_2 << endl;
+			// a + d * k = 0 (mod r)  k = -a / d (mod r)
+			uint64_t k0 = (r - a) % r * Sieve_Inverse(d, r) % r;
+			for (uint64_t j = (k0 + r - first % r) % r; j < count; j += r) {
+				composite[j] = 1;
 			}
-			});
+		}
+	}
 
-		t1.join();
-		t2.join();
+	vector<uint64_t> survivors;
+	for (size_t j = 0; j < count; j++) {
+		if (!composite[j]) survivors.push_back(first + j);
+	}
+	return survivors;
+}
 
-		if (flag == 1) {
-			cout << "count: " << count << " prime: " << result << endl;
+//    
+const uint64_t SIEVE_WINDOW = 1 << 16;
+
+//   k < count,     forms  test.
+//       SIEVE_WINDOW,   
+//   (Parallel_Search). false -   .
+// sieved  tested       
+bool Sieved_Search(const vector<Sieve_Form>& forms, uint64_t count, unsigned threads, const Search_Test& test,
+	uint64_t& result, uint64_t& sieved, uint64_t& tested) {
+	for (uint64_t first = 0; first < count; first += SIEVE_WINDOW) {
+		size_t window = (size_t)min(SIEVE_WINDOW, count - first);
+		vector<uint64_t> survivors = Sieve_Forms(forms, first, window);
+		sieved += window;
+		vector<uint64_t> found = Parallel_Search(survivors.size(), 1, threads,
+			[&](uint64_t i, mt19937_64& rng, const function<bool()>& cancelled) {
+				return test(survivors[i], rng, cancelled);
+			},
+			function<void(uint64_t, size_t)>(), tested);
+		if (!found.empty()) {
+			result = survivors[found[0]];
+			return true;
 		}
+	}
+	return false;
+}
 
-		if (flag == 1 && count == 1)
-			p = result;
+//  
+int Bit_Length(const BigInt& x) {
+	vector<uint8_t> bytes = x.toBytes();
+	int bits = 8 * ((int)bytes.size() - 1);
+	for (uint8_t top = bytes.empty() ? 0 : bytes[0]; top; top >>= 1) bits++;
+	return max(bits, 0);
+}
 
-		if (flag == 1 && count == 2)
-			q = result;
+//      bits 
+BigInt Random_Bits(int bits, mt19937_64& rng) {
+	vector<uint8_t> bytes((bits + 7) / 8);
+	for (size_t i = 0; i < bytes.size(); i++) {
+		bytes[i] = (uint8_t)rng();
+	}
+	const int top_bits = (bits - 1) % 8 + 1;
+	bytes[0] &= (uint8_t)((1 << top_bits) - 1);
+	bytes[0] |= (uint8_t)(1 << (top_bits - 1));
+	bytes.back() |= 1;
+	return BigInt::fromBytes(bytes.data(), bytes.size());
+}
 
-		if (flag == 1 && count == 2)
-			break;
+//     bits : a + 2k    a
+BigInt search_random_prime(int bits, unsigned threads, mt19937_64& rng, uint64_t& sieved, uint64_t& tested) {
+	const int rounds = Miller_Rounds(bits);
+	BigInt a;
+	uint64_t index;
+	auto test = [&](uint64_t k, mt19937_64& rng, const function<bool()>& cancelled) {
+		BigInt num = a + BigInt(2 * k);
+		return Bit_Length(num) == bits && Miller(num, rounds, rng, cancelled);
+	};
+	do {
+		a = Random_Bits(bits, rng);
+	} while (!Sieved_Search({ Sieve_Form(a, 2) }, SIEVE_WINDOW, threads, test, index, sieved, tested));
+	return a + BigInt(2 * index);
+}
 
+//     search_prime
+void print_search_stats(const char* name, uint64_t sieved, uint64_t tested, unsigned threads,
+	chrono::steady_clock::time_point started) {
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+	cout << name << ": sieved: " << sieved << ", candidates: " << tested << ", threads: " << threads
+		<< ", seconds: " << seconds << endl;
+}
 
-		i++;
-		num_1 += "6";
-		num_2 += "6";
+//   p = 2q + 1 (q )  .
+//  q = q0 + 2k  p = 2q0 + 1 + 4k  : 
+// ,         .
+//   :    q,  p,    q
+BigInt search_safe_prime(int bitness, unsigned threads = 0) {
+	TRACE_SPAN("search_safe_prime", "prime");
+	if (bitness < 16) throw("Error: bitness is too small for a safe prime");
+
+	threads = Search_Threads(threads);
+	const int rounds = Miller_Rounds(bitness);
+	mt19937_64 rng(random_device{}());
+	uint64_t sieved = 0, tested = 0, index;
+	auto started = chrono::steady_clock::now();
+
+	BigInt q0;
+	auto test = [&](uint64_t k, mt19937_64& rng, const function<bool()>& cancelled) {
+		TRACE_SPAN("search_safe_prime.candidate", "prime");
+		BigInt q = q0 + BigInt(2 * k);
+		if (Bit_Length(q) != bitness - 1) {
+			return false;
+		}
+		BigInt p = q * "2" + "1";
+		return Miller(q, 1, rng, cancelled) && Miller(p, rounds, rng, cancelled) &&
+			Miller(q, rounds - 1, rng, cancelled);
+	};
+	do {
+		q0 = Random_Bits(bitness - 1, rng);
+	} while (!Sieved_Search({ Sieve_Form(q0, 2), Sieve_Form(q0 * "2" + "1", 4) },
+		SIEVE_WINDOW, threads, test, index, sieved, tested));
+
+	print_search_stats("safe prime", sieved, tested, threads, started);
+	BigInt p = (q0 + BigInt(2 * index)) * "2" + "1";
+	cout << "safe prime: " << p << endl;
+	return p;
+}
 
+//      : p - 1   
+//  r, p + 1 -    s, r - 1 -    t.
+// s  t -  , r = 2it + 1, p = p0 + 2jrs, 
+// p0 = 2 (s^(r-2) mod r) s - 1,   p0 = 1 (mod r), p0 = -1 (mod s).
+//         
+BigInt search_strong_prime(int bitness, unsigned threads = 0) {
+	TRACE_SPAN("search_strong_prime", "prime");
+	if (bitness < 64) throw("Error: bitness is too small for a strong prime");
+
+	threads = Search_Threads(threads);
+	const int rounds = Miller_Rounds(bitness);
+	mt19937_64 rng(random_device{}());
+	uint64_t sieved = 0, tested = 0, index;
+	auto started = chrono::steady_clock::now();
+
+	BigInt base_2("2");
+	BigInt start_indicator(bitness - 1);
+	BigInt start; start = base_2 ^ start_indicator;
+
+	while (true) {
+		// 2rs   21   p:  j   
+		BigInt s = search_random_prime(bitness / 2 - 8, threads, rng, sieved, tested);
+		BigInt t = search_random_prime(bitness / 2 - 16, threads, rng, sieved, tested);
+
+		// r = 2it + 1, i = 1, 2, ...
+		BigInt t2; t2 = t * "2";
+		const int r_rounds = Miller_Rounds(Bit_Length(t2));
+		Sieved_Search({ Sieve_Form(t2 + "1", t2) }, ~0ULL, threads,
+			[&](uint64_t i, mt19937_64& rng, const function<bool()>& cancelled) {
+				return Miller(t2 * BigInt(i + 1) + "1", r_rounds, rng, cancelled);
+			}, index, sieved, tested);
+		BigInt r; r = t2 * BigInt(index + 1) + "1";
+
+		BigInt p0; p0 = base_2 * modulo(s, r - "2", r) * s - "1";
+		BigInt rs2; rs2 = base_2 * r * s;
+		BigInt a; a = p0 + rs2 * ((start - p0) / rs2 + "1");
+		auto test = [&](uint64_t j, mt19937_64& rng, const function<bool()>& cancelled) {
+			TRACE_SPAN("search_strong_prime.candidate", "prime");
+			BigInt p = a + rs2 * BigInt(j);
+			return Bit_Length(p) == bitness && Miller(p, rounds, rng, cancelled);
+		};
+		if (Sieved_Search({ Sieve_Form(a, rs2) }, SIEVE_WINDOW, threads, test, index, sieved, tested)) {
+			print_search_stats("strong prime", sieved, tested, threads, started);
+			BigInt p; p = a + rs2 * BigInt(index);
+			cout << "strong prime: " << p << endl;
+			cout << "r: " << r << endl << "s: " << s << endl << "t: " << t << endl;
+			return p;
+		}
 	}
-	return result;
+}
+
+// k     RSA,    bitness .
+//    ( bitness % k    ), 
+//   : bitness - L ,  L -   ,
+//       sqrt(2) (   ),   
+// ;  ,      bitness .
+//    r - 1    e = 65537
+vector<BigInt> search_multi_prime(int bitness, int count, unsigned threads = 0) {
+	TRACE_SPAN("search_multi_prime", "prime");
+	if (count < 2 || count > 4) throw("Error: multi-prime RSA uses 2 to 4 primes");
+	if (bitness / count < 64) throw("Error: bitness is too small for this many primes");
+
+	threads = Search_Threads(threads);
+	mt19937_64 rng(random_device{}());
+	uint64_t sieved = 0, tested = 0;
+	auto started = chrono::steady_clock::now();
+
+	vector<BigInt> primes;
+	auto next_prime = [&](int bits) {
+		while (true) {
+			BigInt r = search_random_prime(bits, threads, rng, sieved, tested);
+			bool fresh = (r - "1") % "65537" != "0";
+			for (size_t i = 0; fresh && i < primes.size(); i++) {
+				fresh = primes[i] != r;
+			}
+			if (fresh) return r;
+		}
+	};
 
-}
\ No newline at end of file
+	BigInt n("1");
+	for (int i = 0; i + 1 < count; i++) {
+		primes.push_back(next_prime(bitness / count + (i < bitness % count ? 1 : 0)));
+		n = n * primes.back();
+	}
+	const int length = Bit_Length(n);
+	const int last = bitness - length + (Bit_Length(n * n) == 2 * length ? 0 : 1);
+	BigInt r;
+	do {
+		r = next_prime(last);
+	} while (Bit_Length(n * r) != bitness);
+	primes.push_back(r);
+
+	print_search_stats("multi-prime", sieved, tested, threads, started);
+	return primes;
+}
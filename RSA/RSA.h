@@ -6,7 +6,12 @@
 #include <algorithm>  
 #include <vector>    
 #include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <sstream>
 #include "Prime.h"
+#include "ModExp_Batch.h"
 using namespace std;
 
 // Преобразует число в двоичную строку (младший бит первый)
@@ -24,6 +29,8 @@ inline int BianaryTransform(BigInt num, string &bin_num) {
 
 // Модульное возведение в степень: a^e mod n (бинарный алгоритм)
 inline string Modular_Exonentiation(BigInt a, BigInt e, BigInt n) {
+    TRACE_SPAN("modExp", "rsa");
+    BIGINT_STATS_OPERATION(MODPOW, BigInt::statsDigits(a, n));
     string bin_num;
     BigInt res("1");
     int k = BianaryTransform(e, bin_num) - 1;  // Преобразуем степень в двоичный вид
@@ -36,16 +43,14 @@ inline string Modular_Exonentiation(BigInt a, BigInt e, BigInt n) {
     }
 
     // Преобразуем результат в строку
-    string out;
-    for (int i = Length(res) - 1; i >= 0; --i)
-        out += char(res[i] + 48);
-    
-    if (out.empty()) out = "0";
-    return out;
+    ostringstream out;
+    out << res;
+    return out.str();
 }
 
 // Вычисляет наибольший общий делитель (НОД) рекурсивно
 inline BigInt func_gcd(BigInt e, BigInt On) {
+    BIGINT_STATS_OPERATION(GCD, BigInt::statsDigits(e, On));
     if (On != "0") {
         BigInt temp = e % On;           // Остаток от деления
         return func_gcd(On, temp);      // Рекурсивный вызов
@@ -63,6 +68,7 @@ inline BigInt sub_mod(const BigInt& A, const BigInt& B, const BigInt& M) {
 
 // Модульная обратная: d = a^{-1} mod m (расширенный алгоритм Евклида)
 inline BigInt modInverse(BigInt a, const BigInt& m) {
+    BIGINT_STATS_OPERATION(GCD, BigInt::statsDigits(a, m));
     if (m == "1") return BigInt("0");
     
     BigInt m0 = m;
@@ -111,35 +117,15 @@ inline void RSA_Initialize_FromPQ(const BigInt& p, const BigInt& q,
     cout << "d = " << d << endl;
 }
 
-// Convert string to BigInt (encode entire message as a number)
+// Convert string to BigInt (encode entire message as a big-endian number)
 inline BigInt StringToBigInt(const string& str) {
-    BigInt result("0");
-    for (char c : str) {
-        result = result * "256";  // Shift left by 8 bits
-        result = result + BigInt((int)c);
-    }
-    return result;
+    return BigInt::fromBytes(reinterpret_cast<const uint8_t*>(str.data()), str.size());
 }
 
 // Convert BigInt back to string
 inline string BigIntToString(const BigInt& num) {
-    string result;
-    BigInt temp = num;
-    BigInt zero("0");
-    
-    while (temp > zero) {
-        BigInt remainder = temp % "256";
-        // Convert remainder to char
-        int remainder_int = 0;
-        for (int i = Length(remainder) - 1; i >= 0; --i) {
-            remainder_int = remainder_int * 10 + remainder[i];
-        }
-        char ch = (char)remainder_int;
-        result = ch + result;
-        temp = temp / "256";
-    }
-    
-    return result;
+    std::vector<uint8_t> bytes = num.toBytes();
+    return string(bytes.begin(), bytes.end());
 }
 
 // Get maximum message size that can be encrypted with given n
@@ -171,6 +157,7 @@ inline vector<string> SplitMessage(const string& message, size_t chunkSize) {
 inline void RSA_Encrypt_Block(const string& plaintext, 
                               const BigInt& n, const BigInt& e,
                               vector<string>& out) {
+    TRACE_SPAN("rsa.encrypt", "rsa");
     out.clear();
     
     // Calculate maximum block size
@@ -188,6 +175,7 @@ inline void RSA_Encrypt_Block(const string& plaintext,
     
     // Encrypt each chunk
     for (size_t i = 0; i < chunks.size(); ++i) {
+        TRACE_SPAN("rsa.encrypt.block", "rsa");
         // cout << "\nChunk " << i + 1 << "/" << chunks.size() 
         //      << " (size: " << chunks[i].size() << " chars):" << endl;
         cout << "Text: \"" << chunks[i] << "\"" << endl;
@@ -226,28 +214,25 @@ inline std::vector<uint8_t> ToBitsBE(BigInt e) {
     return le;
 }
 
-// Быстрое модульное возведение в степень с методом скользящего окна
-inline BigInt ModExp_WindowBits(BigInt base, const std::vector<uint8_t>& bits, 
-                                const BigInt& mod, int w = 5) {
-    if (mod == "1") return BigInt("0");
-    base = base % mod;  // Нормализация основания
-    if (base == "0") return BigInt("0");
-
-    // Предвычисление таблицы нечётных степеней: g^1, g^3, ..., g^(2^w-1)
-    int tblSize = 1 << (w - 1);
-    std::vector<BigInt> T(tblSize);
-    T[0] = base;  // g^1
-    BigInt g2 = (base * base) % mod;  // g^2
-    for (int i = 1; i < tblSize; ++i)
-        T[i] = (T[i-1] * g2) % mod;  // g^(2i+1) = предыдущее * g^2
-
-    BigInt result("1");
+// Разбиение экспоненты на окна для метода скользящего окна.
+// Шаг (s, idx): s возведений в квадрат, затем умножение на нечётную степень
+// из таблицы с индексом idx (idx = -1 - без умножения, хвостовые нули).
+// Зависит только от экспоненты, поэтому для ключа вычисляется один раз
+struct RSAExponentWindows {
+    int tableSize;  // Сколько нечётных степеней g^1, g^3, ... нужно таблице
+    std::vector<std::pair<int, int> > steps;
+};
+
+inline RSAExponentWindows RecodeExponent(const std::vector<uint8_t>& bits, int w = 5) {
+    RSAExponentWindows windows;
+    windows.tableSize = 0;
+    int squarings = 0;
     size_t i = 0, n = bits.size();
 
     // Проход по битам экспоненты с использованием окна
     while (i < n) {
         if (bits[i] == 0) {
-            result = (result * result) % mod;  // Квадрат при нулевом бите
+            ++squarings;  // Квадрат при нулевом бите
             ++i;
         } else {
             // Формируем окно из следующих w битов
@@ -261,53 +246,194 @@ inline BigInt ModExp_WindowBits(BigInt base, const std::vector<uint8_t>& bits,
             // Откатываем хвостовые нули для получения нечётного значения
             while ((val & 1) == 0) { val >>= 1; --width; --j; }
 
-            // Возведение в квадрат width раз
-            for (int k = 0; k < width; ++k)
-                result = (result * result) % mod;
-
-            // Умножение на предвычисленную степень из таблицы
             int idx = (val - 1) >> 1;  // Индекс в таблице (1->0, 3->1, ...)
-            result = (result * T[idx]) % mod;
+            windows.steps.push_back(std::make_pair(squarings + width, idx));
+            windows.tableSize = std::max(windows.tableSize, idx + 1);
+            squarings = 0;
 
             i = j;  // Переход к следующему окну
         }
     }
+    if (squarings > 0)
+        windows.steps.push_back(std::make_pair(squarings, -1));
+    return windows;
+}
+
+// Модульное возведение в степень по заранее разбитой экспоненте
+inline BigInt ModExp_Windows(BigInt base, const RSAExponentWindows& windows,
+                             const BigInt& mod) {
+    TRACE_SPAN("modExp", "rsa");
+    BIGINT_STATS_OPERATION(MODPOW, BigInt::statsDigits(base, mod));
+    if (mod == "1") return BigInt("0");
+    base = base % mod;  // Нормализация основания
+    if (base == "0") return BigInt("0");
+
+    // Предвычисление таблицы нечётных степеней: g^1, g^3, ..., g^(2*tableSize-1)
+    std::vector<BigInt> T(std::max(windows.tableSize, 1));
+    T[0] = base;  // g^1
+    if (windows.tableSize > 1) {
+        BigInt g2 = (base * base) % mod;  // g^2
+        for (int i = 1; i < windows.tableSize; ++i)
+            T[i] = (T[i-1] * g2) % mod;  // g^(2i+1) = предыдущее * g^2
+    }
+
+    BigInt result("1");
+    for (size_t i = 0; i < windows.steps.size(); ++i) {
+        for (int k = 0; k < windows.steps[i].first; ++k)
+            result = (result * result) % mod;
+        // Умножение на предвычисленную степень из таблицы
+        if (windows.steps[i].second >= 0)
+            result = (result * T[windows.steps[i].second]) % mod;
+    }
     return result;
 }
 
-// Дешифрование одного сообщения 
-inline BigInt RSA_Decrypt_One_CRT(const BigInt& c,
-                                  const BigInt& p, const BigInt& q,
-                                  const BigInt& d) {
+// Быстрое модульное возведение в степень с методом скользящего окна
+inline BigInt ModExp_WindowBits(BigInt base, const std::vector<uint8_t>& bits, 
+                                const BigInt& mod, int w = 5) {
+    return ModExp_Windows(base, RecodeExponent(bits, w), mod);
+}
+
+// Независимые возведения results[i] = bases[i]^exps[i] mod mods[i].
+// Собственное ядро считает их в дорожках Монтгомери (ModExp_Batch.h),
+// с GMP поштучное возведение по окнам быстрее дорожек
+inline vector<BigInt> ModExp_Batch(const vector<BigInt>& bases, const vector<BigInt>& exps,
+                                   const vector<BigInt>& mods) {
+#ifdef BIGINT_BACKEND_GMP
+    if (bases.size() != mods.size() || exps.size() != mods.size())
+        throw("Error: ModExp_Batch operand counts differ");
+    vector<BigInt> results(mods.size());
+    for (size_t i = 0; i < mods.size(); ++i)
+        results[i] = ModExp_WindowBits(bases[i], ToBitsBE(exps[i]), mods[i]);
+    return results;
+#else
+    return ModExp_Batch_Lanes(bases, exps, mods);
+#endif
+}
+
+// Закрытый ключ RSA с предвычисленными параметрами CRT. Загружается один раз,
+// после этого дешифровка блока стоит двух возведений в степень по модулям
+// половинной длины. Не изменяется при дешифровке, поэтому один ключ
+// читают все потоки параллельной дешифровки. Для пакетной дешифровки
+// собственным ядром ключ хранит постоянные Монтгомери p и q
+// (R^2 mod p, R^2 mod q, n0inv) и dp, dq в лимбах
+struct RSAPrivateKey {
+    BigInt n, d;
+    BigInt p, q;
+    BigInt dp;    // d mod (p-1)
+    BigInt dq;    // d mod (q-1)
+    BigInt qInv;  // q^(-1) mod p
+    RSAExponentWindows dpWindows;  // dp, разбитая на окна
+    RSAExponentWindows dqWindows;  // dq, разбитая на окна
+    ModExpLimbs dpLimbs, dqLimbs;  // dp и dq для дорожек Монтгомери
+    ModExpModulus pMontgomery;     // постоянные Монтгомери p (пусто с GMP и для чётного p)
+    ModExpModulus qMontgomery;     // то же для q
+};
+
+// Постоянные Монтгомери p и q и лимбы dp, dq: один раз на ключ,
+// а не на каждый пакет (с GMP дорожки не используются)
+inline void RSA_Prepare_Montgomery(RSAPrivateKey& key) {
+#ifndef BIGINT_BACKEND_GMP
+    const BigInt one("1");
+    key.dpLimbs = ModExp_ToLimbs(key.dp);
+    key.dqLimbs = ModExp_ToLimbs(key.dq);
+    const ModExpLimbs pLimbs = ModExp_ToLimbs(key.p), qLimbs = ModExp_ToLimbs(key.q);
+    if (key.p > one && (pLimbs[0] & 1))
+        key.pMontgomery = ModExpModulus(pLimbs);
+    if (key.q > one && (qLimbs[0] & 1))
+        key.qMontgomery = ModExpModulus(qLimbs);
+#else
+    (void)key;
+#endif
+}
+
+inline RSAPrivateKey RSA_Load_PrivateKey(const BigInt& p, const BigInt& q, const BigInt& d) {
     BigInt one("1");
+    RSAPrivateKey key;
+    key.n = p * q;
+    key.d = d;
+    key.p = p;
+    key.q = q;
     // Вычисляем d по модулю (p-1) и (q-1) для ускорения (разбиваем на 2 степени)
-    BigInt dp = d % (p - one);  // d mod (p-1)
-    BigInt dq = d % (q - one);  // d mod (q-1)
-    BigInt qInv = modInverse(q, p);  // Обратный к q по модулю p
-
-    // Преобразуем экспоненты в биты для быстрого возведения в степень
-    std::vector<uint8_t> bits_dp = ToBitsBE(dp);
-    std::vector<uint8_t> bits_dq = ToBitsBE(dq);
+    key.dp = d % (p - one);
+    key.dq = d % (q - one);
+    key.qInv = modInverse(q, p);  // Обратный к q по модулю p
+    // Сразу разбиваем экспоненты на окна для быстрого возведения в степень
+    key.dpWindows = RecodeExponent(ToBitsBE(key.dp), 5);
+    key.dqWindows = RecodeExponent(ToBitsBE(key.dq), 5);
+    RSA_Prepare_Montgomery(key);
+    return key;
+}
 
+// Дешифрование одного сообщения с загруженным ключом. Два возведения
+// занимают лишь половину дорожек Монтгомери и по окнам выходят быстрее
+inline BigInt RSA_Decrypt_One_CRT(const BigInt& c, const RSAPrivateKey& key) {
+    TRACE_SPAN("rsa.decrypt.block", "rsa");
     // Вычисляем остатки зашифрованного сообщения
-    BigInt c_p = c % p;  // c mod p
-    BigInt c_q = c % q;  // c mod q
+    BigInt c_p = c % key.p;  // c mod p
+    BigInt c_q = c % key.q;  // c mod q
 
     // Возводим в степень по модулю p и q отдельно (быстрее)
-    BigInt m1 = ModExp_WindowBits(c_p, bits_dp, p, 5);  // c^dp mod p
-    BigInt m2 = ModExp_WindowBits(c_q, bits_dq, q, 5);  // c^dq mod q
+    BigInt m1 = ModExp_Windows(c_p, key.dpWindows, key.p);  // c^dp mod p
+    BigInt m2 = ModExp_Windows(c_q, key.dqWindows, key.q);  // c^dq mod q
 
     // Восстанавливаем исходное сообщение по формуле Гарнера
-    BigInt diff = sub_mod(m1, m2, p);  // (m1 - m2) mod p
-    BigInt h = (qInv * diff) % p;  // Коэффициент для восстановления
-    BigInt m = m2 + h * q;  // Итоговое сообщение: m mod n
+    BigInt diff = sub_mod(m1, m2, key.p);  // (m1 - m2) mod p
+    BigInt h = (key.qInv * diff) % key.p;  // Коэффициент для восстановления
+    BigInt m = m2 + h * key.q;  // Итоговое сообщение: m mod n
     return m;
 }
 
+// Дешифрование нескольких сообщений: половинки CRT всех блоков
+// (c^dp mod p и c^dq mod q) считаются одним пакетом в дорожках
+// с подготовленными в ключе модулями p и q
+inline vector<BigInt> RSA_Decrypt_CRT_Batch(const vector<BigInt>& c, const RSAPrivateKey& key) {
+    TRACE_SPAN("rsa.decrypt.batch", "rsa");
+    vector<BigInt> m(c.size());
+#ifdef BIGINT_BACKEND_GMP
+    // Окна dp и dq уже разбиты в ключе - поштучно
+    for (size_t i = 0; i < c.size(); ++i)
+        m[i] = RSA_Decrypt_One_CRT(c[i], key);
+#else
+    vector<BigInt> bases, halves;
+    for (size_t i = 0; i < c.size(); ++i)
+        bases.push_back(c[i] % key.p);
+    for (size_t i = 0; i < c.size(); ++i)
+        bases.push_back(c[i] % key.q);
+    if (key.pMontgomery.size() > 0 && key.qMontgomery.size() > 0) {
+        vector<const ModExpLimbs*> exps(c.size(), &key.dpLimbs);
+        vector<const ModExpModulus*> mods(c.size(), &key.pMontgomery);
+        exps.resize(2 * c.size(), &key.dqLimbs);
+        mods.resize(2 * c.size(), &key.qMontgomery);
+        halves = ModExp_Batch_Prepared(bases, exps, mods);
+    } else {
+        vector<BigInt> exps(c.size(), key.dp), mods(c.size(), key.p);
+        exps.resize(2 * c.size(), key.dq);
+        mods.resize(2 * c.size(), key.q);
+        halves = ModExp_Batch(bases, exps, mods);
+    }
+    for (size_t i = 0; i < c.size(); ++i) {
+        // Формула Гарнера, как в RSA_Decrypt_One_CRT
+        const BigInt& m1 = halves[i];
+        const BigInt& m2 = halves[c.size() + i];
+        BigInt h = (key.qInv * sub_mod(m1, m2, key.p)) % key.p;
+        m[i] = m2 + h * key.q;
+    }
+#endif
+    return m;
+}
+
+// Дешифрование одного сообщения 
+inline BigInt RSA_Decrypt_One_CRT(const BigInt& c,
+                                  const BigInt& p, const BigInt& q,
+                                  const BigInt& d) {
+    return RSA_Decrypt_One_CRT(c, RSA_Load_PrivateKey(p, q, d));
+}
+
 // Decrypt entire message in blocks
 inline string RSA_Decrypt_Block(const vector<string>& cipher,
-                               const BigInt& n, const BigInt& d,
-                               const BigInt& p, const BigInt& q) {
+                               const RSAPrivateKey& key) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
     string result;
     
     // Decrypt each chunk
@@ -319,7 +445,7 @@ inline string RSA_Decrypt_Block(const vector<string>& cipher,
         BigInt M;
         
         // Use CRT for faster decryption
-        M = RSA_Decrypt_One_CRT(C, p, q, d);
+        M = RSA_Decrypt_One_CRT(C, key);
         
         // Convert back to string
         string chunkText = BigIntToString(M);
@@ -331,6 +457,237 @@ inline string RSA_Decrypt_Block(const vector<string>& cipher,
     return result;
 }
 
+inline string RSA_Decrypt_Block(const vector<string>& cipher,
+                               const BigInt& n, const BigInt& d,
+                               const BigInt& p, const BigInt& q) {
+    return RSA_Decrypt_Block(cipher, RSA_Load_PrivateKey(p, q, d));
+}
+
+// Выполняет task(i) для i = 0..count-1 на threads потоках (0 - по числу ядер).
+// Индексы раздаются через атомарный счетчик, а результат каждый блок пишет
+// в свою ячейку, поэтому порядок блоков сохраняется. Первое исключение
+// из рабочего потока пробрасывается после завершения всех потоков.
+template <typename Task>
+inline void RSA_ParallelFor(size_t count, unsigned threads, const Task& task) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > count) threads = (unsigned)count;
+
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.push_back(std::thread([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                try {
+                    task(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                    next = count;  // Остальные блоки не обрабатываем
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < pool.size(); ++t)
+        pool[t].join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+// Encrypt entire message in blocks, blocks are spread across threads
+inline void RSA_Encrypt_Block_Parallel(const string& plaintext,
+                                       const BigInt& n, const BigInt& e,
+                                       vector<string>& out, unsigned threads = 0) {
+    TRACE_SPAN("rsa.encrypt", "rsa");
+    out.clear();
+
+    size_t maxBlockSize = GetMaxMessageSize(n);
+    if (maxBlockSize == 0) {
+        cerr << "Error: n is too small to encrypt even one character!" << endl;
+        return;
+    }
+
+    const vector<string> chunks = SplitMessage(plaintext, maxBlockSize);
+    const std::vector<uint8_t> bits_e = ToBitsBE(e);
+    vector<string> blocks(chunks.size());
+    std::atomic<bool> tooLarge(false);
+
+    RSA_ParallelFor(chunks.size(), threads, [&](size_t i) {
+        TRACE_SPAN("rsa.encrypt.block", "rsa");
+        BigInt m = StringToBigInt(chunks[i]);
+        if (m >= n) {
+            tooLarge = true;
+            return;
+        }
+        std::ostringstream encrypted;
+        encrypted << ModExp_WindowBits(m, bits_e, n, 5);
+        blocks[i] = encrypted.str();
+    });
+
+    if (tooLarge) {
+        cerr << "Error: Message is too large for the modulus!" << endl;
+        return;
+    }
+    out.swap(blocks);
+}
+
+// Decrypt entire message in blocks, blocks are spread across threads
+inline string RSA_Decrypt_Block_Parallel(const vector<string>& cipher,
+                                         const RSAPrivateKey& key,
+                                         unsigned threads = 0) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
+    vector<string> texts(cipher.size());
+
+    // Задача потока - группа из MODEXP_LANES блоков: их половинки CRT
+    // заполняют дорожки ModExp_Batch
+    const size_t group = MODEXP_LANES;
+    RSA_ParallelFor((cipher.size() + group - 1) / group, threads, [&](size_t g) {
+        vector<BigInt> c;
+        for (size_t i = g * group; i < cipher.size() && i < (g + 1) * group; ++i)
+            c.push_back(BigInt(cipher[i]));
+        const vector<BigInt> m = RSA_Decrypt_CRT_Batch(c, key);
+        for (size_t k = 0; k < m.size(); ++k)
+            texts[g * group + k] = BigIntToString(m[k]);
+    });
+
+    string result;
+    for (size_t i = 0; i < texts.size(); ++i)
+        result += texts[i];
+    return result;
+}
+
+inline string RSA_Decrypt_Block_Parallel(const vector<string>& cipher,
+                                         const BigInt& n, const BigInt& d,
+                                         const BigInt& p, const BigInt& q,
+                                         unsigned threads = 0) {
+    if (p * q != n) throw("Error: n is not the product of p and q");
+    return RSA_Decrypt_Block_Parallel(cipher, RSA_Load_PrivateKey(p, q, d), threads);
+}
+
+// Наибольшее число простых многопростого ключа
+const size_t RSA_MAX_PRIMES = 4;
+
+// Простые многопростого RSA: от 2 до RSA_MAX_PRIMES нечетных, попарно различных
+inline void RSA_Check_Primes(const vector<BigInt>& primes) {
+    if (primes.size() < 2 || primes.size() > RSA_MAX_PRIMES)
+        throw("Error: multi-prime RSA needs 2 to 4 primes");
+    for (size_t i = 0; i < primes.size(); ++i) {
+        if (primes[i] < "3" || primes[i] % "2" == "0")
+            throw("Error: multi-prime RSA needs odd primes");
+        for (size_t j = 0; j < i; ++j)
+            if (primes[i] == primes[j])
+                throw("Error: multi-prime RSA needs distinct primes");
+    }
+}
+
+// Функция Кармайкла: lambda(n) = lcm(r1-1, r2-1, ..., rk-1)
+inline BigInt RSA_Lambda(const vector<BigInt>& primes) {
+    BigInt lambda("1");
+    for (size_t i = 0; i < primes.size(); ++i) {
+        const BigInt r1 = primes[i] - "1";
+        lambda = lambda / func_gcd(lambda, r1) * r1;
+    }
+    return lambda;
+}
+
+// Инициализация многопростого RSA: n = r1 * r2 * ... * rk из k различных простых
+inline void RSA_Initialize_FromPrimes(const vector<BigInt>& primes,
+                                      BigInt &n, BigInt &e, BigInt &d) {
+    RSA_Check_Primes(primes);
+    n = "1";
+    for (size_t i = 0; i < primes.size(); ++i)
+        n *= primes[i];                             // Модуль: произведение простых чисел
+    const BigInt lambda = RSA_Lambda(primes);
+
+    e = "65537";                                    // Публичная экспонента
+    if (func_gcd(e, lambda) != "1") {               // Проверяем взаимную простоту с lambda(n)
+        e = "3";                                    // Если 65537 не подходит, начинаем с 3
+        while (func_gcd(e, lambda) != "1") e += "2";    // Ищем следующее нечётное
+    }
+    d = modInverse(e, lambda);                      // Приватная экспонента
+}
+
+// Закрытый ключ многопростого RSA. Для каждого простого r_i хранятся
+// d mod (r_i - 1), разбитая на окна, и коэффициенты формулы Гарнера:
+// prefix[i] = r_0 * ... * r_(i-1), coeff[i] = prefix[i]^(-1) mod r_i
+struct RSAMultiPrimeKey {
+    BigInt n, d;
+    vector<BigInt> primes;
+    vector<BigInt> exponents;                  // d mod (r_i - 1)
+    vector<RSAExponentWindows> windows;        // exponents[i], разбитая на окна
+    vector<BigInt> prefix;                     // prefix[0] = 1
+    vector<BigInt> coeff;                      // coeff[0] не используется
+};
+
+inline RSAMultiPrimeKey RSA_Load_MultiPrimeKey(const vector<BigInt>& primes, const BigInt& d) {
+    RSA_Check_Primes(primes);
+    // d обратима по модулю lambda(n) только при gcd(d, lambda) = 1
+    if (func_gcd(d, RSA_Lambda(primes)) != "1")
+        throw("Error: d is not invertible modulo lambda(n)");
+    BigInt one("1");
+    RSAMultiPrimeKey key;
+    key.d = d;
+    key.primes = primes;
+    BigInt product("1");
+    for (size_t i = 0; i < primes.size(); ++i) {
+        const BigInt& r = primes[i];
+        key.exponents.push_back(d % (r - one));
+        key.windows.push_back(RecodeExponent(ToBitsBE(key.exponents[i]), 5));
+        key.prefix.push_back(product);
+        key.coeff.push_back(i == 0 ? one : modInverse(product % r, r));
+        product *= r;
+    }
+    key.n = product;
+    return key;
+}
+
+// Дешифрование одного сообщения: k возведений в степень по модулям
+// длиной n/k (на threads потоках) и восстановление по формуле Гарнера
+inline BigInt RSA_Decrypt_One_MultiPrime(const BigInt& c, const RSAMultiPrimeKey& key,
+                                         unsigned threads = 1) {
+    TRACE_SPAN("rsa.decrypt.block", "rsa");
+    const size_t k = key.primes.size();
+    vector<BigInt> residues(k);
+    RSA_ParallelFor(k, threads, [&](size_t i) {
+        residues[i] = ModExp_Windows(c % key.primes[i], key.windows[i], key.primes[i]);
+    });
+
+    // m = m_0 + t_1 * r_0 + t_2 * r_0 * r_1 + ...
+    BigInt m = residues[0];
+    for (size_t i = 1; i < k; ++i) {
+        const BigInt& r = key.primes[i];
+        BigInt diff = sub_mod(residues[i], m % r, r);   // (m_i - m) mod r_i
+        BigInt t = (diff * key.coeff[i]) % r;
+        m += t * key.prefix[i];
+    }
+    return m;
+}
+
+// Decrypt entire message in blocks with a multi-prime key, blocks are spread across threads
+inline string RSA_Decrypt_Block_Parallel(const vector<string>& cipher,
+                                         const RSAMultiPrimeKey& key,
+                                         unsigned threads = 0) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
+    vector<string> texts(cipher.size());
+
+    RSA_ParallelFor(cipher.size(), threads, [&](size_t i) {
+        texts[i] = BigIntToString(RSA_Decrypt_One_MultiPrime(BigInt(cipher[i]), key));
+    });
+
+    string result;
+    for (size_t i = 0; i < texts.size(); ++i)
+        result += texts[i];
+    return result;
+}
+
 // Old functions (kept for compatibility)
 inline void RSA_Encrypt_FromKeys(const string& plaintext, 
                                  const BigInt& n, const BigInt& e, 
@@ -346,18 +703,15 @@ inline void RSA_Decrypt_FromKeys_CRT_Fast(const std::vector<std::string>& cipher
     // For backward compatibility
     out.clear(); 
     out.reserve(cipher.size());
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, d);
     
     for (size_t i = 0; i < cipher.size(); ++i) {
         BigInt C(cipher[i]);
-        BigInt M = RSA_Decrypt_One_CRT(C, p, q, d);
+        BigInt M = RSA_Decrypt_One_CRT(C, key);
         
         // Convert to string
-        std::string s; 
-        s.reserve(Length(M));
-        for (int j = Length(M) - 1; j >= 0; --j) 
-            s.push_back(char(M[j] + 48));
-        
-        if (s.empty()) s = "0";
-        out.push_back(s);
+        std::ostringstream s;
+        s << M;
+        out.push_back(s.str());
     }
 }
\ No newline at end of file
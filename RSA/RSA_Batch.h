@@ -0,0 +1,217 @@
+#pragma once
+// Пакетная дешифровка RSA по методу Фиата (Fiat, "Batch RSA", 1989).
+//
+// Один модуль n используется с k различными малыми открытыми экспонентами
+// e_0..e_(k-1): i-й блок пакета шифруется экспонентой e_i. Тогда корни
+// m_i = c_i^(1/e_i) всех k блоков получаются одним полным возведением
+// в степень по CRT и дешёвой работой в дереве:
+//   подъём:  E_S = E_L * E_R,  v_S = v_L^E_R * v_R^E_L   (v листа = c_i)
+//   корень:  m = v^(1/E) mod n                           (одно возведение по CRT)
+//   спуск:   m_L = m_S^Y / (v_L^((Y-1)/E_L) * v_R^(Y/E_R)),  Y = 1 mod E_L, 0 mod E_R
+//            m_R = m_S^X / (v_L^(X/E_L) * v_R^((X-1)/E_R)),  X = 0 mod E_L, 1 mod E_R
+// Знаменатели зависят только от подъёма, поэтому все они обращаются
+// сразу одним modInverse (приём Монтгомери).
+#include "RSA.h"
+
+// Ключ для пакетной дешифровки
+struct RSABatchKey {
+    RSAPrivateKey key;
+    vector<BigInt> e;              // e[i] - экспонента i-го блока пакета
+    RSAExponentWindows rootDp;     // (e_0 * ... * e_(k-1))^(-1) mod (p-1)
+    RSAExponentWindows rootDq;     // (e_0 * ... * e_(k-1))^(-1) mod (q-1)
+};
+
+// Разбитые на окна (E^(-1) mod (p-1), E^(-1) mod (q-1)) для первых count экспонент
+inline void RSA_Batch_RootExponents(const RSABatchKey& batch, size_t count,
+                                    RSAExponentWindows& dp, RSAExponentWindows& dq) {
+    BigInt one("1");
+    BigInt E("1");
+    for (size_t i = 0; i < count; ++i)
+        E *= batch.e[i];
+    const BigInt p1 = batch.key.p - one, q1 = batch.key.q - one;
+    dp = RecodeExponent(ToBitsBE(modInverse(E % p1, p1)), 5);
+    dq = RecodeExponent(ToBitsBE(modInverse(E % q1, q1)), 5);
+}
+
+// Подбирает batchSize малых простых экспонент 3, 5, 7, 11, ...,
+// взаимно простых с p-1 и q-1, и предвычисляет корень для полного пакета
+inline RSABatchKey RSA_Load_BatchKey(const BigInt& p, const BigInt& q, size_t batchSize) {
+    if (batchSize == 0)
+        throw("Error: batch size must be positive");
+    BigInt one("1");
+    const BigInt phi = (p - one) * (q - one);
+    vector<BigInt> exponents;
+    for (unsigned long long candidate = 3; exponents.size() < batchSize; candidate += 2) {
+        bool prime = true;
+        for (unsigned long long f = 3; f * f <= candidate; f += 2)
+            if (candidate % f == 0) { prime = false; break; }
+        if (prime && func_gcd(BigInt(candidate), phi) == one)
+            exponents.push_back(BigInt(candidate));
+    }
+
+    // Закрытая экспонента для RSAPrivateKey: к e_0 (пакет из одного блока)
+    RSABatchKey batch;
+    batch.key = RSA_Load_PrivateKey(p, q, modInverse(exponents[0], phi));
+    batch.e = exponents;
+    RSA_Batch_RootExponents(batch, batch.e.size(), batch.rootDp, batch.rootDq);
+    return batch;
+}
+
+// Обращает все элементы a по модулю n одним modInverse (приём Монтгомери)
+inline vector<BigInt> RSA_Batch_Inverse(const vector<BigInt>& a, const BigInt& n) {
+    vector<BigInt> result(a.size());
+    if (a.empty()) return result;
+    vector<BigInt> prefix(a.size());
+    prefix[0] = a[0];
+    for (size_t i = 1; i < a.size(); ++i)
+        prefix[i] = (prefix[i - 1] * a[i]) % n;
+
+    BigInt inv = modInverse(prefix.back(), n);
+    if ((inv * prefix.back()) % n != BigInt("1"))
+        throw("Error: batch element is not invertible modulo n");
+    for (size_t i = a.size() - 1; i > 0; --i) {
+        result[i] = (inv * prefix[i - 1]) % n;
+        inv = (inv * a[i]) % n;
+    }
+    result[0] = inv;
+    return result;
+}
+
+// Узел дерева пакета: отрезок блоков [lo, hi)
+struct RSABatchNode {
+    size_t left, right;  // Дети (у листа - SIZE_MAX)
+    BigInt E;            // Произведение экспонент отрезка
+    BigInt v;            // Произведение c_i^(E / e_i) mod n
+    BigInt m;            // Произведение корней m_i mod n
+    BigInt X, Y;         // Показатели спуска (см. комментарий в начале файла)
+};
+
+// Подъём по дереву: строит узлы отрезка [lo, hi), возвращает индекс корня
+inline size_t RSA_Batch_Build(const vector<BigInt>& c, const vector<BigInt>& e,
+                              const BigInt& n, size_t lo, size_t hi,
+                              vector<RSABatchNode>& nodes) {
+    RSABatchNode node;
+    node.left = node.right = SIZE_MAX;
+    if (hi - lo == 1) {
+        node.E = e[lo];
+        node.v = c[lo] % n;
+    } else {
+        size_t mid = lo + (hi - lo) / 2;
+        node.left = RSA_Batch_Build(c, e, n, lo, mid, nodes);
+        node.right = RSA_Batch_Build(c, e, n, mid, hi, nodes);
+        const RSABatchNode& L = nodes[node.left];
+        const RSABatchNode& R = nodes[node.right];
+        node.E = L.E * R.E;
+        node.v = (ModExp_WindowBits(L.v, ToBitsBE(R.E), n) *
+                  ModExp_WindowBits(R.v, ToBitsBE(L.E), n)) % n;
+        node.X = L.E * modInverse(L.E, R.E);  // 0 mod E_L, 1 mod E_R
+        node.Y = R.E * modInverse(R.E, L.E);  // 1 mod E_L, 0 mod E_R
+    }
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+// Дешифрует пакет: c[i] зашифрован экспонентой batch.e[i],
+// c.size() <= batch.e.size()
+inline vector<BigInt> RSA_Decrypt_Batch(const vector<BigInt>& c, const RSABatchKey& batch) {
+    TRACE_SPAN("rsa.decrypt.batch", "rsa");
+    if (c.size() > batch.e.size())
+        throw("Error: batch is larger than the number of exponents");
+    vector<BigInt> m(c.size());
+    if (c.empty()) return m;
+    const RSAPrivateKey& key = batch.key;
+    if (c.size() == 1) {
+        m[0] = RSA_Decrypt_One_CRT(c[0], key);
+        return m;
+    }
+
+    vector<RSABatchNode> nodes;
+    nodes.reserve(2 * c.size());
+    size_t root = RSA_Batch_Build(c, batch.e, key.n, 0, c.size(), nodes);
+
+    // Корень: m = v^(1/E) по CRT; для неполного пакета показатели считаются здесь
+    RSAExponentWindows dp, dq;
+    if (c.size() != batch.e.size())
+        RSA_Batch_RootExponents(batch, c.size(), dp, dq);
+    const RSAExponentWindows& rootDp = c.size() == batch.e.size() ? batch.rootDp : dp;
+    const RSAExponentWindows& rootDq = c.size() == batch.e.size() ? batch.rootDq : dq;
+    BigInt m1 = ModExp_Windows(nodes[root].v % key.p, rootDp, key.p);
+    BigInt m2 = ModExp_Windows(nodes[root].v % key.q, rootDq, key.q);
+    BigInt h = (key.qInv * sub_mod(m1, m2, key.p)) % key.p;
+    nodes[root].m = m2 + h * key.q;
+
+    // Знаменатели спуска: два на внутренний узел, обращаются все сразу.
+    // Все четыре степени каждого узла независимы - считаются одним ModExp_Batch
+    vector<BigInt> bases, exps;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const RSABatchNode& node = nodes[i];
+        if (node.left == SIZE_MAX) continue;
+        const RSABatchNode& L = nodes[node.left];
+        const RSABatchNode& R = nodes[node.right];
+        bases.push_back(L.v); exps.push_back((node.Y - "1") / L.E);
+        bases.push_back(R.v); exps.push_back(node.Y / R.E);
+        bases.push_back(L.v); exps.push_back(node.X / L.E);
+        bases.push_back(R.v); exps.push_back((node.X - "1") / R.E);
+    }
+    const vector<BigInt> powers = ModExp_Batch(bases, exps, vector<BigInt>(bases.size(), key.n));
+    vector<BigInt> dens;
+    for (size_t i = 0; i < powers.size(); i += 2)
+        dens.push_back((powers[i] * powers[i + 1]) % key.n);
+    const vector<BigInt> inv = RSA_Batch_Inverse(dens, key.n);
+
+    // Спуск: узлы идут в порядке обхода снизу вверх, поэтому родитель
+    // обрабатывается раньше детей при проходе с конца
+    size_t denIndex = dens.size();
+    for (size_t i = nodes.size(); i-- > 0;) {
+        RSABatchNode& node = nodes[i];
+        if (node.left == SIZE_MAX) continue;
+        denIndex -= 2;
+        nodes[node.left].m = (ModExp_WindowBits(node.m, ToBitsBE(node.Y), key.n) * inv[denIndex]) % key.n;
+        nodes[node.right].m = (ModExp_WindowBits(node.m, ToBitsBE(node.X), key.n) * inv[denIndex + 1]) % key.n;
+    }
+
+    // Листья в порядке обхода соответствуют блокам 0..k-1
+    size_t leaf = 0;
+    for (size_t i = 0; i < nodes.size(); ++i)
+        if (nodes[i].left == SIZE_MAX)
+            m[leaf++] = nodes[i].m;
+    return m;
+}
+
+// Encrypt entire message in blocks, block i uses exponent e[i % k]
+inline void RSA_Encrypt_Block_Batch(const string& plaintext, const BigInt& n,
+                                    const vector<BigInt>& e, vector<string>& out) {
+    TRACE_SPAN("rsa.encrypt", "rsa");
+    out.clear();
+    size_t maxBlockSize = GetMaxMessageSize(n);
+    if (maxBlockSize == 0) {
+        cerr << "Error: n is too small to encrypt even one character!" << endl;
+        return;
+    }
+
+    vector<RSAExponentWindows> windows;
+    for (size_t i = 0; i < e.size(); ++i)
+        windows.push_back(RecodeExponent(ToBitsBE(e[i]), 5));
+    const vector<string> chunks = SplitMessage(plaintext, maxBlockSize);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        std::ostringstream encrypted;
+        encrypted << ModExp_Windows(StringToBigInt(chunks[i]), windows[i % e.size()], n);
+        out.push_back(encrypted.str());
+    }
+}
+
+// Decrypt entire message in batches of k blocks (k = number of exponents)
+inline string RSA_Decrypt_Block_Batch(const vector<string>& cipher, const RSABatchKey& batch) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
+    string result;
+    const size_t k = batch.e.size();
+    for (size_t start = 0; start < cipher.size(); start += k) {
+        vector<BigInt> c;
+        for (size_t i = start; i < cipher.size() && i < start + k; ++i)
+            c.push_back(BigInt(cipher[i]));
+        const vector<BigInt> m = RSA_Decrypt_Batch(c, batch);
+        for (size_t i = 0; i < m.size(); ++i)
+            result += BigIntToString(m[i]);
+    }
+    return result;
+}
@@ -0,0 +1,315 @@
+﻿/*# Compile
+g++ -std=c++11 -O2 -pthread -I. -I../common -o rsa_bench RSA_Bench.cpp
+# Compile with GMP arithmetic
+g++ -std=c++11 -O2 -pthread -I. -I../common -DBIGINT_BACKEND_GMP -o rsa_bench RSA_Bench.cpp -lgmpxx -lgmp
+# Add -DBIGINT_STATS to print BigInt operation counters at the end
+
+# Run: p and q files, number of blocks, multi-prime modulus bits
+./rsa_bench p_mid.txt q_mid.txt 64 2048
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Prime.h"
+#include "RSA.h"
+#include "RSA_Batch.h"
+#include "RSA_Hybrid.h"
+#include "RSA_KeyFile.h"
+#include "RSA_Sign.h"
+
+using namespace std;
+
+// ==================== ВСПОМОГАТЕЛЬНЫЕ ====================
+
+static bool read_number(const string& path, string& out) {
+    ifstream fin(path);
+    if (!(fin >> out)) {
+        cerr << "Cannot read number from: " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+static double seconds_since(const chrono::steady_clock::time_point& start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Случайные блоки максимальной длины для модуля n
+// (первый байт ненулевой: BigIntToString не восстанавливает ведущие нули)
+static vector<string> random_blocks(const BigInt& n, size_t count) {
+    size_t blockSize = GetMaxMessageSize(n);
+    vector<string> blocks(count, string(blockSize, '\0'));
+    for (size_t i = 0; i < count; ++i)
+        for (size_t j = 0; j < blockSize; ++j)
+            blocks[i][j] = char(j == 0 ? 1 + rand() % 255 : rand() % 256);
+    return blocks;
+}
+
+static void print_row(const string& name, size_t blocks, double seconds, double baseline) {
+    cout << left << setw(24) << name << right
+         << setw(12) << fixed << setprecision(3) << seconds * 1e3 / blocks << " ms/op"
+         << setw(10) << setprecision(2) << baseline / seconds << "x" << endl;
+}
+
+static void print_rate(const string& name, double bytes, double seconds, double baseline) {
+    cout << left << setw(24) << name << right
+         << setw(12) << fixed << setprecision(1) << bytes / seconds / (1 << 20) << " MB/s"
+         << setw(10) << setprecision(2) << baseline / seconds * bytes << "x" << endl;
+}
+
+// ==================== ПАКЕТНАЯ ДЕШИФРОВКА ====================
+
+// Дешифровка по CRT поблочно (e = 65537) против пакетной по Фиату
+static void bench_batch_decrypt(const BigInt& p, const BigInt& q, size_t count) {
+    cout << "--- Decryption: per-block CRT vs CRT batch and Fiat batch ---" << endl;
+    const BigInt n = p * q;
+    const vector<string> blocks = random_blocks(n, count);
+
+    BigInt one("1");
+    BigInt e("65537");
+    const BigInt d = modInverse(e, (p - one) * (q - one));
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, d);
+    const RSAExponentWindows eWindows = RecodeExponent(ToBitsBE(e), 5);
+
+    vector<BigInt> cipher;
+    for (size_t i = 0; i < count; ++i)
+        cipher.push_back(ModExp_Windows(StringToBigInt(blocks[i]), eWindows, n));
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    size_t bad = 0;
+    for (size_t i = 0; i < count; ++i)
+        if (BigIntToString(RSA_Decrypt_One_CRT(cipher[i], key)) != blocks[i]) ++bad;
+    double baseline = seconds_since(start);
+    print_row("crt", count, baseline, baseline);
+
+    // Половинки CRT всех блоков в одном ModExp_Batch
+    start = chrono::steady_clock::now();
+    const vector<BigInt> lanes = RSA_Decrypt_CRT_Batch(cipher, key);
+    print_row("crt batch", count, seconds_since(start), baseline);
+    for (size_t i = 0; i < count; ++i)
+        if (BigIntToString(lanes[i]) != blocks[i]) ++bad;
+
+    const size_t sizes[] = {2, 4, 8, 16, 32};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        const size_t k = sizes[s];
+        if (k > count) break;
+        const RSABatchKey batch = RSA_Load_BatchKey(p, q, k);
+        vector<string> encrypted;
+        string plaintext;
+        for (size_t i = 0; i < count; ++i)
+            plaintext += blocks[i];
+        RSA_Encrypt_Block_Batch(plaintext, n, batch.e, encrypted);
+
+        start = chrono::steady_clock::now();
+        string recovered = RSA_Decrypt_Block_Batch(encrypted, batch);
+        double seconds = seconds_since(start);
+        if (recovered != plaintext) ++bad;
+        print_row("batch k=" + to_string(k), count, seconds, baseline);
+    }
+    if (bad)
+        cout << "MISMATCH: " << bad << " results differ" << endl;
+}
+
+// ==================== МНОГОПРОСТОЙ RSA ====================
+
+// Дешифровка по CRT из двух простых против формулы Гарнера для k = 2..4
+// простых при одной длине модуля bits (простые - search_multi_prime)
+static void bench_multi_prime(int bits, size_t count) {
+    cout << "--- Decryption: 2-prime CRT vs k-prime Garner, " << bits << "-bit n ---" << endl;
+    double baseline = 0;
+    size_t bad = 0;
+    for (size_t k = 2; k <= RSA_MAX_PRIMES; ++k) {
+        const vector<BigInt> primes = search_multi_prime(bits, (int)k);
+        BigInt n, e, d;
+        RSA_Initialize_FromPrimes(primes, n, e, d);
+        const RSAMultiPrimeKey key = RSA_Load_MultiPrimeKey(primes, d);
+        const RSAExponentWindows eWindows = RecodeExponent(ToBitsBE(e), 5);
+        const vector<string> blocks = random_blocks(n, count);
+        vector<BigInt> cipher;
+        for (size_t i = 0; i < count; ++i)
+            cipher.push_back(ModExp_Windows(StringToBigInt(blocks[i]), eWindows, n));
+
+        chrono::steady_clock::time_point start;
+        if (k == 2) {
+            const RSAPrivateKey crt = RSA_Load_PrivateKey(primes[0], primes[1], d);
+            start = chrono::steady_clock::now();
+            for (size_t i = 0; i < count; ++i)
+                if (BigIntToString(RSA_Decrypt_One_CRT(cipher[i], crt)) != blocks[i]) ++bad;
+            baseline = seconds_since(start);
+            print_row("crt k=2", count, baseline, baseline);
+        }
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+            if (BigIntToString(RSA_Decrypt_One_MultiPrime(cipher[i], key)) != blocks[i]) ++bad;
+        print_row("garner k=" + to_string(k), count, seconds_since(start), baseline);
+
+        // Возведения по модулям r_i - на k потоках
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+            if (BigIntToString(RSA_Decrypt_One_MultiPrime(cipher[i], key, (unsigned)k)) != blocks[i]) ++bad;
+        print_row("garner k=" + to_string(k) + " threads", count, seconds_since(start), baseline);
+    }
+    if (bad)
+        cout << "MISMATCH: " << bad << " results differ" << endl;
+}
+
+// ==================== ПРОВЕРКА ПОДПИСЕЙ ====================
+
+// Пропускная способность проверки подписей при e = 65537
+static void bench_verify(const BigInt& p, const BigInt& q, size_t count) {
+    cout << "--- Signature verification, e = 65537 ---" << endl;
+    const BigInt n = p * q;
+    const vector<string> blocks = random_blocks(n, count);
+
+    BigInt one("1");
+    const BigInt e("65537");
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, modInverse(e, (p - one) * (q - one)));
+    const RSAPublicKey pub = RSA_Load_PublicKey(n, e);
+
+    vector<BigInt> m, s;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        m.push_back(StringToBigInt(blocks[i]));
+        s.push_back(RSA_Sign(m[i], key));
+    }
+    double signSeconds = seconds_since(start);
+
+    // Базовая линия: общее возведение в степень по окнам
+    size_t bad = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        if (ModExp_Windows(s[i], pub.eWindows, n) != m[i]) ++bad;
+    double baseline = seconds_since(start);
+    print_row("sign (crt)", count, signSeconds, baseline);
+    print_row("verify windows", count, baseline, baseline);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        if (!RSA_Verify(m[i], s[i], pub)) ++bad;
+    print_row("verify chain", count, seconds_since(start), baseline);
+
+    start = chrono::steady_clock::now();
+    const vector<bool> ok = RSA_Verify_Batch(m, s, pub);
+    print_row("verify batch", count, seconds_since(start), baseline);
+    for (size_t i = 0; i < ok.size(); ++i)
+        if (!ok[i]) ++bad;
+
+    start = chrono::steady_clock::now();
+    if (!RSA_Screen_Batch(m, s, pub)) ++bad;
+    print_row("screen batch", count, seconds_since(start), baseline);
+
+    // Испорченная подпись должна отсекаться и скринингом, и поштучно
+    s[count / 2] = (s[count / 2] + one) % n;
+    if (RSA_Screen_Batch(m, s, pub) || RSA_Verify_Batch(m, s, pub)[count / 2]) ++bad;
+
+    if (bad)
+        cout << "MISMATCH: " << bad << " results differ" << endl;
+}
+
+// ==================== ЗАГРУЗКА КЛЮЧА ====================
+
+// Вычисление ключа из p и q против чтения двоичного файла ключа
+static void bench_key_load(const BigInt& p, const BigInt& q) {
+    cout << "--- Key load: from p, q vs key file ---" << endl;
+    const string path = "rsa_bench_key.bin";
+    BigInt one("1");
+    const BigInt e("65537");
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, modInverse(e, (p - one) * (q - one)));
+    double baseline = seconds_since(start);
+    print_row("from p, q", 1, baseline, baseline);
+
+    RSA_Save_KeyFile(path, key, e);
+    BigInt loadedE;
+    start = chrono::steady_clock::now();
+    const RSAPrivateKey loaded = RSA_Read_KeyFile(path, loadedE);
+    print_row("key file (mmap)", 1, seconds_since(start), baseline);
+    remove(path.c_str());
+
+    if (loaded.n != key.n || loaded.qInv != key.qInv || loadedE != e ||
+        loaded.dpWindows.steps != key.dpWindows.steps)
+        cout << "MISMATCH: loaded key differs" << endl;
+}
+
+// ==================== ГИБРИДНОЕ ШИФРОВАНИЕ ====================
+
+// Скорость шифрования файла: блоками RSA против RSA-KEM + ChaCha20
+static void bench_hybrid(const BigInt& p, const BigInt& q, size_t count) {
+    cout << "--- File encryption: RSA blocks vs RSA-KEM + ChaCha20 ---" << endl;
+    const BigInt n = p * q;
+    BigInt one("1");
+    const BigInt e("65537");
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, modInverse(e, (p - one) * (q - one)));
+    const RSAPublicKey pub = RSA_Load_PublicKey(n, e);
+
+    // Базовая линия: поблочное RSA-шифрование count блоков
+    const vector<string> blocks = random_blocks(n, count);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        RSA_Public_Op(StringToBigInt(blocks[i]), pub);
+    double seconds = seconds_since(start);
+    const double blockBytes = (double)count * GetMaxMessageSize(n);
+    // baseline - секунд на байт
+    const double baseline = seconds / blockBytes;
+    print_rate("rsa blocks", blockBytes, seconds, baseline);
+
+    string payload(64 << 20, '\0');
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = char(rand() % 256);
+
+    std::istringstream plain(payload);
+    std::ostringstream encrypted;
+    start = chrono::steady_clock::now();
+    RSA_Hybrid_Encrypt(plain, encrypted, pub);
+    print_rate("hybrid encrypt", payload.size(), seconds_since(start), baseline);
+
+    std::istringstream cipherIn(encrypted.str());
+    std::ostringstream decrypted;
+    start = chrono::steady_clock::now();
+    RSA_Hybrid_Decrypt(cipherIn, decrypted, key);
+    print_rate("hybrid decrypt", payload.size(), seconds_since(start), baseline);
+    if (decrypted.str() != payload)
+        cout << "MISMATCH: hybrid round trip differs" << endl;
+
+    // Только потоковый шифр, без KEM и копирования потоков
+    const uint8_t zeroKey[32] = {0}, zeroNonce[12] = {0};
+    ChaCha20 cipher(zeroKey, zeroNonce);
+    start = chrono::steady_clock::now();
+    cipher.apply(reinterpret_cast<uint8_t*>(&payload[0]), payload.size());
+    print_rate("chacha20", payload.size(), seconds_since(start), baseline);
+}
+
+int main(int argc, char** argv) {
+    const string p_file = argc > 1 ? argv[1] : "p_lit.txt";
+    const string q_file = argc > 2 ? argv[2] : "q_lit.txt";
+    const size_t count = argc > 3 ? (size_t)atoi(argv[3]) : 64;
+    const int multiPrimeBits = argc > 4 ? atoi(argv[4]) : 1024;
+
+    string p_str, q_str;
+    if (!read_number(p_file, p_str) || !read_number(q_file, q_str))
+        return 1;
+    const BigInt p(p_str), q(q_str);
+    srand(1);
+    BigIntStats::reset();
+
+    cout << "n: " << Length(p * q) << " digits, " << count << " blocks" << endl;
+    bench_key_load(p, q);
+    bench_batch_decrypt(p, q, count);
+    bench_verify(p, q, count);
+    bench_hybrid(p, q, count);
+    bench_multi_prime(multiPrimeBits, count);
+
+    if (BigIntStats::enabled())
+        BigIntStats::print(cout);
+    return 0;
+}
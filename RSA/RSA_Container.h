@@ -0,0 +1,189 @@
+#pragma once
+// Двоичный контейнер шифротекста (вместо десятичных строк cipher.txt).
+//
+// Заголовок, 24 байта, все поля big-endian:
+//   0  "RSAC"          - сигнатура
+//   4  uint32 version  - версия формата (RSA_CONTAINER_VERSION)
+//   8  uint32 blockBytes - ширина блока в байтах (длина модуля n)
+//   12 uint32 lastBlockBytes - длина последнего блока открытого текста
+//                      (0 - неизвестна, ведущие нулевые байты не восстанавливаются)
+//   16 uint64 blockCount
+// Далее blockCount блоков по blockBytes байт, big-endian, с ведущими нулями.
+// Блок i лежит по смещению 24 + i * blockBytes, поэтому файл читается
+// через mmap без разбора.
+#include <fstream>
+#include "RSA_MappedFile.h"
+#include "RSA_Stream.h"
+
+const uint32_t RSA_CONTAINER_VERSION = 1;
+const size_t RSA_CONTAINER_HEADER_SIZE = 24;
+
+struct RSA_ContainerHeader {
+    uint32_t version;
+    uint32_t blockBytes;
+    uint32_t lastBlockBytes;
+    uint64_t blockCount;
+};
+
+// Ширина блока контейнера для модуля n
+inline uint32_t RSA_ContainerBlockBytes(const BigInt& n) {
+    return (uint32_t)n.toBytes().size();
+}
+
+inline void RSA_WriteContainerHeader(std::ostream& out, uint32_t blockBytes, uint64_t blockCount,
+                                     uint32_t lastBlockBytes) {
+    uint8_t head[RSA_CONTAINER_HEADER_SIZE] = {'R', 'S', 'A', 'C'};
+    for (int i = 0; i < 4; ++i) {
+        head[4 + i] = (uint8_t)(RSA_CONTAINER_VERSION >> (24 - 8 * i));
+        head[8 + i] = (uint8_t)(blockBytes >> (24 - 8 * i));
+        head[12 + i] = (uint8_t)(lastBlockBytes >> (24 - 8 * i));
+    }
+    for (int i = 0; i < 8; ++i)
+        head[16 + i] = (uint8_t)(blockCount >> (56 - 8 * i));
+    out.write(reinterpret_cast<const char*>(head), sizeof(head));
+    if (!out) throw("Error: cannot write ciphertext container");
+}
+
+inline RSA_ContainerHeader RSA_ParseContainerHeader(const uint8_t* head, size_t size) {
+    if (size < RSA_CONTAINER_HEADER_SIZE || memcmp(head, "RSAC", 4) != 0)
+        throw("Error: not a ciphertext container");
+    RSA_ContainerHeader header = {0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        header.version = (header.version << 8) | head[4 + i];
+        header.blockBytes = (header.blockBytes << 8) | head[8 + i];
+        header.lastBlockBytes = (header.lastBlockBytes << 8) | head[12 + i];
+    }
+    for (int i = 0; i < 8; ++i)
+        header.blockCount = (header.blockCount << 8) | head[16 + i];
+    if (header.version != RSA_CONTAINER_VERSION)
+        throw("Error: unsupported ciphertext container version");
+    if (header.blockBytes == 0 ||
+        header.blockCount > (size - RSA_CONTAINER_HEADER_SIZE) / header.blockBytes)
+        throw("Error: truncated ciphertext container");
+    return header;
+}
+
+// Блок фиксированной ширины: число big-endian с ведущими нулями
+inline string RSA_ContainerBlock(const BigInt& c, uint32_t blockBytes) {
+    std::vector<uint8_t> bytes = c.toBytes();
+    if (bytes.size() > blockBytes)
+        throw("Error: ciphertext block is wider than the modulus");
+    string block(blockBytes - bytes.size(), '\0');
+    block.append(bytes.begin(), bytes.end());
+    return block;
+}
+
+// Контейнер, отображённый в память только для чтения
+class RSA_ContainerFile {
+    RSA_MappedFile file;
+    RSA_ContainerHeader head;
+
+public:
+    explicit RSA_ContainerFile(const string& path)
+        : file(path), head(RSA_ParseContainerHeader(file.data(), file.size())) {
+        file.adviseSequential();
+    }
+
+    const RSA_ContainerHeader& header() const { return head; }
+
+    // Указатель на блок i (header().blockBytes байт)
+    const uint8_t* block(uint64_t i) const {
+        return file.data() + RSA_CONTAINER_HEADER_SIZE + i * head.blockBytes;
+    }
+
+    BigInt blockValue(uint64_t i) const {
+        return BigInt::fromBytes(block(i), head.blockBytes);
+    }
+};
+
+// Шифрует поток in размером inputBytes в контейнер
+inline uint64_t RSA_Encrypt_Container(std::istream& in, std::ostream& out, uint64_t inputBytes,
+                                      const BigInt& n, const BigInt& e,
+                                      const RSA_StreamOptions& options = RSA_StreamOptions()) {
+    TRACE_SPAN("rsa.encrypt", "rsa");
+    const size_t blockSize = GetMaxMessageSize(n);
+    if (blockSize == 0)
+        throw("Error: n is too small to encrypt even one character!");
+    const uint32_t blockBytes = RSA_ContainerBlockBytes(n);
+    const uint64_t blockCount = RSA_StreamBlockCount(inputBytes, n);
+    const RSAExponentWindows eWindows = RecodeExponent(ToBitsBE(e), 5);
+    const size_t batchBlocks = options.batchBlocks ? options.batchBlocks : 1;
+
+    RSA_WriteContainerHeader(out, blockBytes, blockCount,
+                             (uint32_t)RSA_StreamLastBlockBytes(inputBytes, n));
+    string buffer(blockSize * batchBlocks, '\0');
+    uint64_t blocks = RSA_RunPipeline(options,
+        [&](vector<string>& batch) {
+            in.read(&buffer[0], buffer.size());
+            size_t got = (size_t)in.gcount();
+            if (in.bad()) throw("Error: cannot read plaintext stream");
+            for (size_t i = 0; i < got; i += blockSize)
+                batch.push_back(buffer.substr(i, min(blockSize, got - i)));
+        },
+        [&](const string& chunk) {
+            return RSA_ContainerBlock(ModExp_Windows(StringToBigInt(chunk), eWindows, n), blockBytes);
+        },
+        [&](const vector<string>& batch) {
+            for (size_t i = 0; i < batch.size(); ++i)
+                out.write(batch[i].data(), batch[i].size());
+            if (!out) throw("Error: cannot write ciphertext container");
+        });
+    if (blocks != blockCount)
+        throw("Error: plaintext size does not match the container header");
+    return blocks;
+}
+
+// Дешифрует контейнер и пишет исходные байты в out
+inline uint64_t RSA_Decrypt_Container(const RSA_ContainerFile& container, std::ostream& out,
+                                      const RSAPrivateKey& key,
+                                      const RSA_StreamOptions& options = RSA_StreamOptions()) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
+    const RSA_ContainerHeader& header = container.header();
+    if (header.blockBytes != RSA_ContainerBlockBytes(key.n))
+        throw("Error: container block width does not match the key");
+    const size_t blockSize = GetMaxMessageSize(key.n);
+    if (header.lastBlockBytes > blockSize)
+        throw("Error: container last block is longer than a block");
+    const size_t batchBlocks = options.batchBlocks ? options.batchBlocks : 1;
+
+    RSA_PlaintextWriter writer(out, blockSize, header.lastBlockBytes);
+    uint64_t next = 0;
+    uint64_t blocks = RSA_RunPipeline(options,
+        [&](vector<string>& batch) {
+            for (; next < header.blockCount && batch.size() < batchBlocks; ++next) {
+                const char* block = reinterpret_cast<const char*>(container.block(next));
+                batch.push_back(string(block, header.blockBytes));
+            }
+        },
+        [&](const string& block) {
+            BigInt c = BigInt::fromBytes(reinterpret_cast<const uint8_t*>(block.data()), block.size());
+            return BigIntToString(RSA_Decrypt_One_CRT(c, key));
+        },
+        [&](const vector<string>& batch) { writer.write(batch); });
+    writer.finish();
+    return blocks;
+}
+
+// Преобразует текстовый шифротекст (строка заголовка, затем десятичные блоки
+// по строкам, как в cipher.txt) в контейнер для модуля n
+inline uint64_t RSA_Container_FromText(std::istream& text, std::ostream& out, const BigInt& n) {
+    string line;
+    if (!getline(text, line))
+        throw("Error: cannot read number of blocks");
+    uint64_t blockCount;
+    size_t lastBlockBytes;
+    RSA_ParseStreamHeader(line, blockCount, lastBlockBytes);
+    const uint32_t blockBytes = RSA_ContainerBlockBytes(n);
+
+    RSA_WriteContainerHeader(out, blockBytes, blockCount, (uint32_t)lastBlockBytes);
+    for (uint64_t i = 0; i < blockCount; ++i) {
+        if (!getline(text, line))
+            throw("Error: ciphertext has fewer blocks than declared");
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        string block = RSA_ContainerBlock(BigInt(line), blockBytes);
+        out.write(block.data(), block.size());
+    }
+    if (!out) throw("Error: cannot write ciphertext container");
+    return blockCount;
+}
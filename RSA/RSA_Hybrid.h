@@ -0,0 +1,158 @@
+#pragma once
+// Гибридное шифрование больших файлов: RSA-KEM + ChaCha20.
+//
+// RSA применяется к данным один раз на файл: выбирается случайное r < n,
+// в заголовок пишется c = r^e mod n, а из r через KDF2-SHA-256 выводятся
+// ключ и nonce ChaCha20 (RSA-KEM, ISO/IEC 18033-2). Сами данные шифруются
+// потоковым шифром кусками по chunkBytes, поэтому скорость определяется
+// ChaCha20 и вводом-выводом, а память не зависит от размера файла.
+// Как и остальные режимы, шифрование не аутентифицировано.
+//
+// Формат (поля big-endian):
+//   0  "RSAH"            - сигнатура
+//   4  uint32 version    - версия формата (RSA_HYBRID_VERSION)
+//   8  uint32 kemBytes   - длина c в байтах (байтовая длина n)
+//   12 uint32 reserved   - 0
+//   16 c                 - kemBytes байт, дополнено нулями слева
+//   далее данные, зашифрованные ChaCha20 (длина равна длине открытого текста)
+#include <random>
+#include "ChaCha20.h"
+#include "SHA256.h"
+#include "RSA_KeyFile.h"
+#include "RSA_Sign.h"
+
+const uint32_t RSA_HYBRID_VERSION = 1;
+const size_t RSA_HYBRID_HEADER_BYTES = 16;
+
+// Ключ и nonce ChaCha20, выведенные из секрета KEM
+struct RSA_HybridSession {
+    uint8_t key[32];
+    uint8_t nonce[12];
+
+    ~RSA_HybridSession() {
+        volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(this);
+        for (size_t i = 0; i < sizeof(*this); ++i)
+            p[i] = 0;
+    }
+};
+
+// Число фиксированной ширины width байт (big-endian, нули слева)
+inline std::vector<uint8_t> RSA_Hybrid_FixedBytes(const BigInt& value, size_t width) {
+    std::vector<uint8_t> bytes = value.toBytes();
+    if (bytes.size() > width) throw("Error: number does not fit the KEM field");
+    bytes.insert(bytes.begin(), width - bytes.size(), 0);
+    return bytes;
+}
+
+// KDF2: SHA-256(Z || counter) для counter = 1, 2; первые 44 байта - ключ и nonce
+inline void RSA_Hybrid_DeriveSession(const std::vector<uint8_t>& secret, RSA_HybridSession& session) {
+    uint8_t output[64];
+    for (uint32_t counter = 1; counter <= 2; ++counter) {
+        const uint8_t suffix[4] = {0, 0, 0, (uint8_t)counter};
+        SHA256 hash;
+        hash.update(secret.data(), secret.size());
+        hash.update(suffix, 4);
+        hash.finish(output + 32 * (counter - 1));
+    }
+    memcpy(session.key, output, 32);
+    memcpy(session.nonce, output + 32, 12);
+    memset(output, 0, sizeof(output));
+}
+
+// Инкапсуляция: случайное 1 < r < n, возвращает c = r^e mod n
+inline BigInt RSA_KEM_Encapsulate(const RSAPublicKey& pub, RSA_HybridSession& session) {
+    TRACE_SPAN("rsa.kem.encapsulate", "rsa");
+    const std::vector<uint8_t> nBytes = pub.n.toBytes();
+    const size_t width = nBytes.size();
+    if (width < 2) throw("Error: n is too small for RSA-KEM");
+
+    // Маска старшего байта отсекает числа длиннее n; остальные >= n отбрасываются
+    uint8_t topMask = 0;
+    while (topMask < nBytes[0]) topMask = (uint8_t)((topMask << 1) | 1);
+
+    std::random_device device;
+    std::vector<uint8_t> secret(width);
+    BigInt r;
+    do {
+        for (size_t i = 0; i < width; ++i)
+            secret[i] = (uint8_t)device();
+        secret[0] &= topMask;
+        r = BigInt::fromBytes(secret.data(), width);
+    } while (r >= pub.n || r <= BigInt(1));
+
+    RSA_Hybrid_DeriveSession(secret, session);
+    std::fill(secret.begin(), secret.end(), 0);
+    return RSA_Public_Op(r, pub);
+}
+
+// Декапсуляция: r = c^d mod n по CRT, затем тот же KDF
+inline void RSA_KEM_Decapsulate(const BigInt& c, const RSAPrivateKey& key, RSA_HybridSession& session) {
+    TRACE_SPAN("rsa.kem.decapsulate", "rsa");
+    if (c >= key.n) throw("Error: KEM ciphertext is out of range");
+    std::vector<uint8_t> secret = RSA_Hybrid_FixedBytes(RSA_Decrypt_One_CRT(c, key), key.n.toBytes().size());
+    RSA_Hybrid_DeriveSession(secret, session);
+    std::fill(secret.begin(), secret.end(), 0);
+}
+
+// Пропускает поток через ChaCha20 кусками по chunkBytes.
+// Возвращает число обработанных байт
+inline uint64_t RSA_Hybrid_Apply(std::istream& in, std::ostream& out,
+                                 const RSA_HybridSession& session, size_t chunkBytes) {
+    ChaCha20 cipher(session.key, session.nonce);
+    std::vector<char> buffer(chunkBytes ? chunkBytes : 1);
+    uint64_t total = 0;
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        size_t got = (size_t)in.gcount();
+        if (in.bad()) throw("Error: cannot read input stream");
+        if (got == 0) break;
+        cipher.apply(reinterpret_cast<uint8_t*>(buffer.data()), got);
+        out.write(buffer.data(), got);
+        if (!out) throw("Error: cannot write output stream");
+        total += got;
+    }
+    return total;
+}
+
+// Шифрует поток in в out для открытого ключа pub.
+// Возвращает число зашифрованных байт
+inline uint64_t RSA_Hybrid_Encrypt(std::istream& in, std::ostream& out, const RSAPublicKey& pub,
+                                   size_t chunkBytes = 1 << 20) {
+    TRACE_SPAN("rsa.hybrid.encrypt", "rsa");
+    RSA_HybridSession session;
+    const size_t width = pub.n.toBytes().size();
+    const std::vector<uint8_t> c = RSA_Hybrid_FixedBytes(RSA_KEM_Encapsulate(pub, session), width);
+
+    out.write("RSAH", 4);
+    RSA_KeyFile_PutU32(out, RSA_HYBRID_VERSION);
+    RSA_KeyFile_PutU32(out, (uint32_t)width);
+    RSA_KeyFile_PutU32(out, 0);
+    out.write(reinterpret_cast<const char*>(c.data()), c.size());
+    if (!out) throw("Error: cannot write hybrid header");
+    return RSA_Hybrid_Apply(in, out, session, chunkBytes);
+}
+
+// Дешифрует поток, записанный RSA_Hybrid_Encrypt.
+// Возвращает число расшифрованных байт
+inline uint64_t RSA_Hybrid_Decrypt(std::istream& in, std::ostream& out, const RSAPrivateKey& key,
+                                   size_t chunkBytes = 1 << 20) {
+    TRACE_SPAN("rsa.hybrid.decrypt", "rsa");
+    uint8_t header[RSA_HYBRID_HEADER_BYTES];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if ((size_t)in.gcount() != sizeof(header) || memcmp(header, "RSAH", 4) != 0)
+        throw("Error: not a hybrid ciphertext");
+    RSA_KeyFileReader reader = {header, sizeof(header), 4};
+    if (reader.u32() != RSA_HYBRID_VERSION)
+        throw("Error: unsupported hybrid ciphertext version");
+    const uint32_t width = reader.u32();
+    if (width != key.n.toBytes().size())
+        throw("Error: hybrid ciphertext was made for another key");
+
+    std::vector<uint8_t> c(width);
+    in.read(reinterpret_cast<char*>(c.data()), width);
+    if ((size_t)in.gcount() != width) throw("Error: truncated hybrid ciphertext");
+
+    RSA_HybridSession session;
+    RSA_KEM_Decapsulate(BigInt::fromBytes(c.data(), width), key, session);
+    return RSA_Hybrid_Apply(in, out, session, chunkBytes);
+}
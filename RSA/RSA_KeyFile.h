@@ -0,0 +1,158 @@
+#pragma once
+// Двоичный файл ключа с предвычисленными полями.
+//
+// Все поля big-endian:
+//   0  "RSAK"           - сигнатура
+//   4  uint32 version   - версия формата (RSA_KEYFILE_VERSION)
+//   8  uint32 flags     - RSA_KEYFILE_WINDOWS: записаны окна dp и dq
+//   12 uint32 reserved  - 0
+//   16 n, e, d, p, q, dp, dq, qInv: uint32 длина + байты числа
+//   далее (при RSA_KEYFILE_WINDOWS) для dp и dq:
+//      uint32 tableSize, uint32 stepCount, stepCount пар (uint32, int32)
+// Загрузка не выполняет modInverse, деления и разбиения экспонент:
+// числа импортируются из байтов, окна копируются как есть
+// (постоянные Монтгомери p и q считаются сдвигами, без деления).
+#include "RSA_MappedFile.h"
+#include "RSA.h"
+
+const uint32_t RSA_KEYFILE_VERSION = 1;
+const uint32_t RSA_KEYFILE_WINDOWS = 1;
+
+inline void RSA_KeyFile_PutU32(std::ostream& out, uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; ++i)
+        bytes[i] = (char)(value >> (24 - 8 * i));
+    out.write(bytes, 4);
+}
+
+inline void RSA_KeyFile_PutNumber(std::ostream& out, const BigInt& value) {
+    const std::vector<uint8_t> bytes = value.toBytes();
+    RSA_KeyFile_PutU32(out, (uint32_t)bytes.size());
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+inline void RSA_KeyFile_PutWindows(std::ostream& out, const RSAExponentWindows& windows) {
+    RSA_KeyFile_PutU32(out, (uint32_t)windows.tableSize);
+    RSA_KeyFile_PutU32(out, (uint32_t)windows.steps.size());
+    for (size_t i = 0; i < windows.steps.size(); ++i) {
+        RSA_KeyFile_PutU32(out, (uint32_t)windows.steps[i].first);
+        RSA_KeyFile_PutU32(out, (uint32_t)windows.steps[i].second);
+    }
+}
+
+// Записывает загруженный ключ и открытую экспоненту e
+inline void RSA_Write_KeyFile(std::ostream& out, const RSAPrivateKey& key, const BigInt& e,
+                              bool withWindows = true) {
+    out.write("RSAK", 4);
+    RSA_KeyFile_PutU32(out, RSA_KEYFILE_VERSION);
+    RSA_KeyFile_PutU32(out, withWindows ? RSA_KEYFILE_WINDOWS : 0);
+    RSA_KeyFile_PutU32(out, 0);
+
+    RSA_KeyFile_PutNumber(out, key.n);
+    RSA_KeyFile_PutNumber(out, e);
+    RSA_KeyFile_PutNumber(out, key.d);
+    RSA_KeyFile_PutNumber(out, key.p);
+    RSA_KeyFile_PutNumber(out, key.q);
+    RSA_KeyFile_PutNumber(out, key.dp);
+    RSA_KeyFile_PutNumber(out, key.dq);
+    RSA_KeyFile_PutNumber(out, key.qInv);
+    if (withWindows) {
+        RSA_KeyFile_PutWindows(out, key.dpWindows);
+        RSA_KeyFile_PutWindows(out, key.dqWindows);
+    }
+    if (!out) throw("Error: cannot write key file");
+}
+
+// Записывает ключ в файл path с правами только для владельца (0600).
+// Файл создается или усекается и получает эти права до записи закрытых полей
+inline void RSA_Save_KeyFile(const string& path, const RSAPrivateKey& key, const BigInt& e,
+                             bool withWindows = true) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    if (fd < 0) throw("Error: cannot create key file");
+    // У существующего файла open права не меняет
+    const bool restricted = fchmod(fd, 0600) == 0;
+    ::close(fd);
+    if (!restricted) throw("Error: cannot restrict key file permissions");
+#endif
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) throw("Error: cannot open key file");
+    RSA_Write_KeyFile(out, key, e, withWindows);
+}
+
+// Последовательное чтение полей с проверкой границ
+struct RSA_KeyFileReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    const uint8_t* take(size_t count) {
+        if (count > size - pos) throw("Error: truncated key file");
+        const uint8_t* p = data + pos;
+        pos += count;
+        return p;
+    }
+
+    uint32_t u32() {
+        const uint8_t* p = take(4);
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+
+    BigInt number() {
+        uint32_t length = u32();
+        return BigInt::fromBytes(take(length), length);
+    }
+
+    RSAExponentWindows windows() {
+        RSAExponentWindows result;
+        result.tableSize = (int)u32();
+        uint32_t count = u32();
+        if (count > (size - pos) / 8) throw("Error: truncated key file");
+        result.steps.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            result.steps[i].first = (int)u32();
+            result.steps[i].second = (int)(int32_t)u32();
+            if (result.steps[i].second >= result.tableSize || result.steps[i].second < -1)
+                throw("Error: corrupted key file");
+        }
+        if (result.tableSize < 0 || result.tableSize > (1 << 15))
+            throw("Error: corrupted key file");
+        return result;
+    }
+};
+
+// Разбирает файл ключа, находящийся в памяти
+inline RSAPrivateKey RSA_Parse_KeyFile(const uint8_t* data, size_t size, BigInt& e) {
+    RSA_KeyFileReader reader = {data, size, 0};
+    if (size < 16 || memcmp(reader.take(4), "RSAK", 4) != 0)
+        throw("Error: not a key file");
+    if (reader.u32() != RSA_KEYFILE_VERSION)
+        throw("Error: unsupported key file version");
+    uint32_t flags = reader.u32();
+    reader.u32();
+
+    RSAPrivateKey key;
+    key.n = reader.number();
+    e = reader.number();
+    key.d = reader.number();
+    key.p = reader.number();
+    key.q = reader.number();
+    key.dp = reader.number();
+    key.dq = reader.number();
+    key.qInv = reader.number();
+    if (flags & RSA_KEYFILE_WINDOWS) {
+        key.dpWindows = reader.windows();
+        key.dqWindows = reader.windows();
+    } else {
+        key.dpWindows = RecodeExponent(ToBitsBE(key.dp), 5);
+        key.dqWindows = RecodeExponent(ToBitsBE(key.dq), 5);
+    }
+    RSA_Prepare_Montgomery(key);
+    return key;
+}
+
+// Загружает ключ из файла через mmap
+inline RSAPrivateKey RSA_Read_KeyFile(const string& path, BigInt& e) {
+    RSA_MappedFile file(path);
+    return RSA_Parse_KeyFile(file.data(), file.size(), e);
+}
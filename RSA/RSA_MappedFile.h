@@ -0,0 +1,67 @@
+#pragma once
+// Файл, отображённый в память только для чтения (mmap).
+// Под Windows файл читается в память целиком.
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class RSA_MappedFile {
+    const uint8_t* bytes;
+    size_t length;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#else
+    void* mapping;
+#endif
+
+public:
+    explicit RSA_MappedFile(const std::string& path) : bytes(nullptr), length(0) {
+#ifdef _WIN32
+        std::ifstream fin(path.c_str(), std::ios::binary);
+        if (!fin) throw("Error: cannot open file");
+        buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        bytes = buffer.data();
+        length = buffer.size();
+#else
+        mapping = MAP_FAILED;
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw("Error: cannot open file");
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            length = (size_t)st.st_size;
+            mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (mapping == MAP_FAILED) throw("Error: cannot map file");
+        bytes = static_cast<const uint8_t*>(mapping);
+#endif
+    }
+
+    ~RSA_MappedFile() {
+#ifndef _WIN32
+        munmap(mapping, length);
+#endif
+    }
+
+    RSA_MappedFile(const RSA_MappedFile&) = delete;
+    RSA_MappedFile& operator=(const RSA_MappedFile&) = delete;
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    // Подсказка ядру о последовательном чтении
+    void adviseSequential() const {
+#ifndef _WIN32
+        madvise(mapping, length, MADV_SEQUENTIAL);
+#endif
+    }
+};
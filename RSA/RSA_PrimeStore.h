@@ -0,0 +1,244 @@
+#pragma once
+// Хранилище готовых простых чисел: двоичный файл с записями разной битности.
+//
+// Файл только дополняется. Все поля big-endian:
+//   0  "RSAP"           - сигнатура
+//   4  uint32 version   - версия формата (RSA_PRIMESTORE_VERSION)
+//   8  uint32 reserved  - 0
+//   12 uint32 reserved  - 0
+//   16 записи подряд:
+//      uint32 bits      - битность простого
+//      uint32 length    - длина числа в байтах
+//      uint8  state     - RSA_PRIMESTORE_FREE или RSA_PRIMESTORE_TAKEN
+//      uint8[3]         - 0
+//      length байт числа, дополнено нулями до кратного 4
+// Читатель отображает файл в память, по заголовкам записей строит индекс
+// битность -> свободные записи и выдает простые без разбора десятичных строк.
+// Выданная запись помечается в файле до возврата числа под блокировкой
+// файла (flock), поэтому одно простое не выдается дважды ни читателями из
+// разных процессов, ни после перезапуска. Под Windows блокировки нет и
+// гарантия действует только внутри процесса. Недописанная последняя запись
+// (прерванный генератор) пропускается читателем и отрезается писателем
+// перед дозаписью.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include "RSA_MappedFile.h"
+#include "BigInt.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sys/file.h>
+#endif
+
+const uint32_t RSA_PRIMESTORE_VERSION = 1;
+const size_t RSA_PRIMESTORE_HEADER_BYTES = 16;
+const size_t RSA_PRIMESTORE_RECORD_BYTES = 12;
+const uint8_t RSA_PRIMESTORE_FREE = 0;
+const uint8_t RSA_PRIMESTORE_TAKEN = 1;
+
+inline void RSA_PrimeStore_PutU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        out[i] = (uint8_t)(value >> (24 - 8 * i));
+}
+
+inline uint32_t RSA_PrimeStore_GetU32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Размер целой записи со смещения pos или 0, если запись недописана
+inline size_t RSA_PrimeStore_RecordBytes(const uint8_t* data, size_t size, size_t pos) {
+    if (size - pos < RSA_PRIMESTORE_RECORD_BYTES) return 0;
+    const size_t length = RSA_PrimeStore_GetU32(data + pos + 4);
+    const size_t padded = (length + 3) / 4 * 4;
+    if (length == 0 || padded > size - pos - RSA_PRIMESTORE_RECORD_BYTES) return 0;
+    return RSA_PRIMESTORE_RECORD_BYTES + padded;
+}
+
+inline bool RSA_PrimeStore_Truncate(const std::string& path, size_t size) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    const bool ok = _chsize_s(fd, (long long)size) == 0;
+    _close(fd);
+    return ok;
+#else
+    return ::truncate(path.c_str(), (off_t)size) == 0;
+#endif
+}
+
+// Дописывающий в хранилище писатель; один объект можно использовать
+// из нескольких потоков генерации. Каждая запись пишется целиком одним
+// блоком и сразу сбрасывается на диск
+class RSA_PrimeStoreWriter {
+    std::ofstream out;
+    std::mutex writeMutex;
+
+public:
+    explicit RSA_PrimeStoreWriter(const std::string& path) {
+        // Существующий файл должен быть хранилищем, новый получает заголовок.
+        // Хвост после последней целой записи отрезается: иначе дописанные
+        // следом записи читались бы со сдвигом
+        size_t size = 0, complete = 0;
+        {
+            std::ifstream existing(path.c_str(), std::ios::binary | std::ios::ate);
+            if (existing) size = (size_t)existing.tellg();
+        }
+        if (size >= RSA_PRIMESTORE_HEADER_BYTES) {
+            RSA_MappedFile file(path);
+            const uint8_t* data = file.data();
+            if (memcmp(data, "RSAP", 4) != 0) throw("Error: not a prime store");
+            if (RSA_PrimeStore_GetU32(data + 4) != RSA_PRIMESTORE_VERSION)
+                throw("Error: unsupported prime store version");
+            complete = RSA_PRIMESTORE_HEADER_BYTES;
+            while (size_t bytes = RSA_PrimeStore_RecordBytes(data, file.size(), complete))
+                complete += bytes;
+        } else if (size > 0) {
+            // Недописанный заголовок: допустимо только начало сигнатуры
+            std::ifstream existing(path.c_str(), std::ios::binary);
+            char magic[4];
+            const size_t n = std::min(size, sizeof(magic));
+            if (!existing.read(magic, n) || memcmp(magic, "RSAP", n) != 0)
+                throw("Error: not a prime store");
+        }
+        if (complete < size && !RSA_PrimeStore_Truncate(path, complete))
+            throw("Error: cannot truncate prime store");
+
+        out.open(path.c_str(), std::ios::binary | std::ios::app);
+        if (!out) throw("Error: cannot open prime store");
+        if (complete == 0) {
+            uint8_t header[RSA_PRIMESTORE_HEADER_BYTES] = {'R', 'S', 'A', 'P'};
+            RSA_PrimeStore_PutU32(header + 4, RSA_PRIMESTORE_VERSION);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            out.flush();
+            if (!out) throw("Error: cannot write prime store");
+        }
+    }
+
+    RSA_PrimeStoreWriter(const RSA_PrimeStoreWriter&) = delete;
+    RSA_PrimeStoreWriter& operator=(const RSA_PrimeStoreWriter&) = delete;
+
+    // Число в байтах big-endian (старший байт не ноль)
+    void append(const uint8_t* bytes, size_t length) {
+        if (length == 0 || bytes[0] == 0) throw("Error: prime must be written without leading zeros");
+        uint32_t bits = 8 * (uint32_t)(length - 1);
+        for (uint8_t top = bytes[0]; top; top >>= 1) ++bits;
+
+        std::vector<uint8_t> record(RSA_PRIMESTORE_RECORD_BYTES + (length + 3) / 4 * 4, 0);
+        RSA_PrimeStore_PutU32(&record[0], bits);
+        RSA_PrimeStore_PutU32(&record[4], (uint32_t)length);
+        record[8] = RSA_PRIMESTORE_FREE;
+        memcpy(&record[RSA_PRIMESTORE_RECORD_BYTES], bytes, length);
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        out.write(reinterpret_cast<const char*>(record.data()), record.size());
+        out.flush();
+        if (!out) throw("Error: cannot write prime store");
+    }
+
+    void append(const BigInt& prime) {
+        const std::vector<uint8_t> bytes = prime.toBytes();
+        append(bytes.data(), bytes.size());
+    }
+};
+
+// Читатель: индекс по битности и выдача неиспользованных простых
+class RSA_PrimeStore {
+    RSA_MappedFile file;
+    std::fstream marks;                                 // Для пометки выданных записей
+    std::map<uint32_t, std::vector<size_t> > freeRecords;    // Смещения записей, выдаются с конца
+    std::mutex takeMutex;
+#ifndef _WIN32
+    int lockFd;                                         // Для flock между процессами
+
+    struct FileLock {
+        int fd;
+        explicit FileLock(int fd) : fd(fd) {
+            if (flock(fd, LOCK_EX) != 0) throw("Error: cannot lock prime store");
+        }
+        ~FileLock() { flock(fd, LOCK_UN); }
+    };
+#endif
+
+public:
+    explicit RSA_PrimeStore(const std::string& path)
+        : file(path), marks(path.c_str(), std::ios::binary | std::ios::in | std::ios::out)
+#ifndef _WIN32
+        , lockFd(-1)
+#endif
+    {
+        const uint8_t* data = file.data();
+        const size_t size = file.size();
+        if (size < RSA_PRIMESTORE_HEADER_BYTES || memcmp(data, "RSAP", 4) != 0)
+            throw("Error: not a prime store");
+        if (RSA_PrimeStore_GetU32(data + 4) != RSA_PRIMESTORE_VERSION)
+            throw("Error: unsupported prime store version");
+        if (!marks) throw("Error: cannot open prime store for writing");
+
+        size_t pos = RSA_PRIMESTORE_HEADER_BYTES;
+        while (size_t bytes = RSA_PrimeStore_RecordBytes(data, size, pos)) {
+            if (data[pos + 8] == RSA_PRIMESTORE_FREE)
+                freeRecords[RSA_PrimeStore_GetU32(data + pos)].push_back(pos);
+            pos += bytes;
+        }
+        // Первыми выдаются записи из начала файла
+        for (std::map<uint32_t, std::vector<size_t> >::iterator it = freeRecords.begin();
+             it != freeRecords.end(); ++it)
+            std::reverse(it->second.begin(), it->second.end());
+#ifndef _WIN32
+        lockFd = ::open(path.c_str(), O_RDONLY);
+        if (lockFd < 0) throw("Error: cannot open prime store for locking");
+#endif
+    }
+
+#ifndef _WIN32
+    ~RSA_PrimeStore() { ::close(lockFd); }
+#endif
+
+    RSA_PrimeStore(const RSA_PrimeStore&) = delete;
+    RSA_PrimeStore& operator=(const RSA_PrimeStore&) = delete;
+
+    // Число свободных простых битности bits по индексу; записи, выданные
+    // с тех пор другими процессами, в нем еще учтены
+    size_t available(uint32_t bits) {
+        std::lock_guard<std::mutex> lock(takeMutex);
+        std::map<uint32_t, std::vector<size_t> >::const_iterator it = freeRecords.find(bits);
+        return it == freeRecords.end() ? 0 : it->second.size();
+    }
+
+    // Выдает свободное простое битности bits и помечает его в файле.
+    // false - простых этой битности не осталось
+    bool take(uint32_t bits, BigInt& prime) {
+        size_t pos;
+        {
+            std::lock_guard<std::mutex> lock(takeMutex);
+#ifndef _WIN32
+            FileLock fileLock(lockFd);
+#endif
+            std::vector<size_t>& records = freeRecords[bits];
+            for (;;) {
+                if (records.empty()) return false;
+                pos = records.back();
+                records.pop_back();
+                // Запись могли выдать из другого процесса после построения индекса
+                char state;
+                marks.seekg(pos + 8);
+                if (!marks.read(&state, 1)) throw("Error: cannot read prime store");
+                if ((uint8_t)state == RSA_PRIMESTORE_FREE) break;
+            }
+
+            const char taken = (char)RSA_PRIMESTORE_TAKEN;
+            marks.seekp(pos + 8);
+            marks.write(&taken, 1);
+            marks.flush();
+            if (!marks) throw("Error: cannot update prime store");
+        }
+        const uint8_t* record = file.data() + pos;
+        prime = BigInt::fromBytes(record + RSA_PRIMESTORE_RECORD_BYTES, RSA_PrimeStore_GetU32(record + 4));
+        return true;
+    }
+};
@@ -0,0 +1,417 @@
+#pragma once
+// Долгоживущий локальный сервис RSA на Unix-сокете.
+//
+// Ключ загружается один раз; запросы encrypt / decrypt / sign / verify
+// от всех подключений собираются в пакеты и выполняются пулом потоков.
+//
+// Протокол: кадр = uint32 длина (big-endian) + тело.
+//   запрос:  uint8 op, затем поля (uint32 длина + байты)
+//   ответ:   uint8 статус (0 - успех, 1 - ошибка), затем поля;
+//            при ошибке единственное поле - текст ошибки
+//   ENCRYPT  [сообщение]          -> [шифротекст, big-endian]
+//   DECRYPT  [шифротекст]         -> [сообщение]
+//   SIGN     [сообщение]          -> [подпись, big-endian]
+//   VERIFY   [сообщение, подпись] -> [1 байт: 1 - верна, 0 - нет]
+//   STATS    []                   -> [текст: задержки и размеры пакетов]
+//   SHUTDOWN []                   -> [] и остановка сервиса
+// Сообщение - не длиннее GetMaxMessageSize(n) байт (один блок RSA).
+#ifdef _WIN32
+#error "RSA_Service.h requires Unix domain sockets"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <set>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "RSA.h"
+#include "RSA_Sign.h"
+
+const uint8_t RSA_OP_ENCRYPT = 1;
+const uint8_t RSA_OP_DECRYPT = 2;
+const uint8_t RSA_OP_SIGN = 3;
+const uint8_t RSA_OP_VERIFY = 4;
+const uint8_t RSA_OP_STATS = 5;
+const uint8_t RSA_OP_SHUTDOWN = 6;
+
+const uint32_t RSA_SERVICE_MAX_FRAME = 1u << 24;
+const size_t RSA_SERVICE_LATENCY_WINDOW = 4096;   // Задержек в статистике (последние)
+
+// ===== Кадры и поля =====
+
+inline bool RSA_Service_WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written <= 0) return false;
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+inline bool RSA_Service_ReadAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t got = ::recv(fd, data, size, 0);
+        if (got <= 0) return false;
+        data += got;
+        size -= (size_t)got;
+    }
+    return true;
+}
+
+inline void RSA_Service_PutU32(string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back((char)(value >> (24 - 8 * i)));
+}
+
+inline uint32_t RSA_Service_GetU32(const char* p) {
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+inline bool RSA_Service_WriteFrame(int fd, const string& body) {
+    string frame;
+    RSA_Service_PutU32(frame, (uint32_t)body.size());
+    frame += body;
+    return RSA_Service_WriteAll(fd, frame.data(), frame.size());
+}
+
+inline bool RSA_Service_ReadFrame(int fd, string& body) {
+    char head[4];
+    if (!RSA_Service_ReadAll(fd, head, 4)) return false;
+    uint32_t size = RSA_Service_GetU32(head);
+    if (size > RSA_SERVICE_MAX_FRAME) return false;
+    body.assign(size, '\0');
+    return size == 0 || RSA_Service_ReadAll(fd, &body[0], size);
+}
+
+// Тело кадра: байт кода (op или статус) и поля
+inline string RSA_Service_Pack(uint8_t code, const vector<string>& fields) {
+    string body(1, (char)code);
+    for (size_t i = 0; i < fields.size(); ++i) {
+        RSA_Service_PutU32(body, (uint32_t)fields[i].size());
+        body += fields[i];
+    }
+    return body;
+}
+
+inline bool RSA_Service_Unpack(const string& body, uint8_t& code, vector<string>& fields) {
+    if (body.empty()) return false;
+    code = (uint8_t)body[0];
+    fields.clear();
+    size_t pos = 1;
+    while (pos < body.size()) {
+        if (body.size() - pos < 4) return false;
+        uint32_t size = RSA_Service_GetU32(body.data() + pos);
+        pos += 4;
+        if (size > body.size() - pos) return false;
+        fields.push_back(body.substr(pos, size));
+        pos += size;
+    }
+    return true;
+}
+
+inline string RSA_Service_Bytes(const BigInt& value) {
+    const std::vector<uint8_t> bytes = value.toBytes();
+    return string(bytes.begin(), bytes.end());
+}
+
+inline BigInt RSA_Service_Number(const string& bytes) {
+    return BigInt::fromBytes(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+}
+
+// Процентили задержек в микросекундах: "n=... p50=... p90=... p99=... max=..."
+inline string RSA_Percentiles(vector<double> micros) {
+    std::ostringstream out;
+    out << "n=" << micros.size();
+    if (micros.empty()) return out.str();
+    std::sort(micros.begin(), micros.end());
+    const double points[] = {0.50, 0.90, 0.99};
+    const char* names[] = {"p50", "p90", "p99"};
+    for (int i = 0; i < 3; ++i) {
+        size_t index = (size_t)(points[i] * (micros.size() - 1) + 0.5);
+        out << " " << names[i] << "=" << (long long)micros[index] << "us";
+    }
+    out << " max=" << (long long)micros.back() << "us";
+    return out.str();
+}
+
+// ===== Сервис =====
+
+struct RSA_ServiceOptions {
+    unsigned threads;  // Потоков пула (0 - по числу ядер)
+    size_t maxBatch;   // Запросов в одном пакете
+
+    RSA_ServiceOptions() : threads(0), maxBatch(64) {}
+};
+
+class RSA_Service {
+    struct Request {
+        string body;
+        string response;
+        std::chrono::steady_clock::time_point start;
+        bool done;
+    };
+
+    const RSAPrivateKey key;
+    const RSAPublicKey pub;
+    const RSA_ServiceOptions options;
+    const size_t maxMessage;
+
+    // Очередь запросов к пулу
+    std::mutex queueMutex;
+    std::condition_variable queueReady, requestDone;
+    std::deque<Request*> queue;
+    bool stopping;
+
+    // Статистика: задержки последних RSA_SERVICE_LATENCY_WINDOW запросов
+    // (кольцевой буфер, latencyNext - место следующей записи) и счетчики
+    mutable std::mutex statsMutex;
+    vector<double> latencies;
+    size_t latencyNext;
+    uint64_t requests;
+    uint64_t batches;
+
+    // Подключения обслуживаются отсоединенными потоками; serve ждет, пока
+    // их число не станет нулевым. Запрос SHUTDOWN пишет в wakePipe, чтобы
+    // прервать poll
+    int listenFd;
+    int wakePipe[2];
+    std::mutex clientsMutex;
+    std::condition_variable clientsDone;
+    std::set<int> clients;
+
+public:
+    RSA_Service(const RSAPrivateKey& key, const BigInt& e,
+                const RSA_ServiceOptions& options = RSA_ServiceOptions())
+        : key(key), pub(RSA_Load_PublicKey(key.n, e)), options(options),
+          maxMessage(GetMaxMessageSize(key.n)), stopping(false), latencyNext(0), requests(0),
+          batches(0), listenFd(-1) {
+        wakePipe[0] = wakePipe[1] = -1;
+    }
+
+    // Принимает подключения на socketPath до запроса SHUTDOWN
+    void serve(const string& socketPath) {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path))
+            throw("Error: socket path is too long");
+        strcpy(addr.sun_path, socketPath.c_str());
+
+        if (::pipe(wakePipe) != 0) throw("Error: cannot create pipe");
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ::unlink(socketPath.c_str());
+        if (listenFd < 0 || ::bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+            ::listen(listenFd, 64) != 0) {
+            if (listenFd >= 0) ::close(listenFd);
+            ::close(wakePipe[0]);
+            ::close(wakePipe[1]);
+            throw("Error: cannot listen on socket");
+        }
+
+        std::thread dispatcher([this]() { dispatch(); });
+        for (;;) {
+            pollfd fds[2] = {{listenFd, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[1].revents) break;  // Пришёл SHUTDOWN
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                break;
+            }
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            clients.insert(fd);
+            std::thread([this, fd]() { connection(fd); }).detach();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(clientsMutex);
+            for (std::set<int>::iterator it = clients.begin(); it != clients.end(); ++it)
+                ::shutdown(*it, SHUT_RDWR);
+            clientsDone.wait(lock, [this]() { return clients.empty(); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        dispatcher.join();
+        ::close(listenFd);
+        ::close(wakePipe[0]);
+        ::close(wakePipe[1]);
+        ::unlink(socketPath.c_str());
+    }
+
+    // Задержки запросов (от приёма до готового ответа) и размеры пакетов
+    string stats() const {
+        vector<double> window;
+        uint64_t total, batchCount;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            window = latencies;
+            total = requests;
+            batchCount = batches;
+        }
+        std::ostringstream out;
+        out << RSA_Percentiles(window) << " requests=" << total << " batches=" << batchCount;
+        if (batchCount)
+            out << " avg_batch=" << std::fixed << std::setprecision(1)
+                << (double)total / batchCount;
+        return out.str();
+    }
+
+private:
+    // Выполняет один запрос ENCRYPT / DECRYPT / SIGN / VERIFY
+    string handle(const string& body) {
+        uint8_t op;
+        vector<string> fields;
+        try {
+            if (!RSA_Service_Unpack(body, op, fields) || fields.size() != (op == RSA_OP_VERIFY ? 2u : 1u))
+                throw("Error: malformed request");
+            vector<string> result;
+            if (op == RSA_OP_ENCRYPT) {
+                if (fields[0].size() > maxMessage) throw("Error: Message is too large for the modulus!");
+                result.push_back(RSA_Service_Bytes(RSA_Public_Op(StringToBigInt(fields[0]), pub)));
+            } else if (op == RSA_OP_DECRYPT) {
+                BigInt c = RSA_Service_Number(fields[0]);
+                if (c >= key.n) throw("Error: ciphertext is not below the modulus");
+                result.push_back(BigIntToString(RSA_Decrypt_One_CRT(c, key)));
+            } else if (op == RSA_OP_SIGN) {
+                if (fields[0].size() > maxMessage) throw("Error: Message is too large for the modulus!");
+                result.push_back(RSA_Service_Bytes(RSA_Sign(StringToBigInt(fields[0]), key)));
+            } else if (op == RSA_OP_VERIFY) {
+                bool ok = RSA_Verify(StringToBigInt(fields[0]), RSA_Service_Number(fields[1]), pub);
+                result.push_back(string(1, ok ? '\1' : '\0'));
+            } else {
+                throw("Error: unknown operation");
+            }
+            return RSA_Service_Pack(0, result);
+        } catch (const char* msg) {
+            return RSA_Service_Pack(1, vector<string>(1, msg));
+        } catch (const std::exception& ex) {
+            return RSA_Service_Pack(1, vector<string>(1, string("Error: ") + ex.what()));
+        } catch (...) {
+            return RSA_Service_Pack(1, vector<string>(1, "Error: request failed"));
+        }
+    }
+
+    // Пул: забирает из очереди до maxBatch запросов и выполняет их параллельно
+    void dispatch() {
+        for (;;) {
+            vector<Request*> batch;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                while (!queue.empty() && batch.size() < options.maxBatch) {
+                    batch.push_back(queue.front());
+                    queue.pop_front();
+                }
+            }
+
+            TRACE_SPAN("rsa.service.batch", "rsa");
+            RSA_ParallelFor(batch.size(), options.threads, [&](size_t i) {
+                batch[i]->response = handle(batch[i]->body);
+            });
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    const double micros = std::chrono::duration<double, std::micro>(now - batch[i]->start).count();
+                    if (latencies.size() < RSA_SERVICE_LATENCY_WINDOW) latencies.push_back(micros);
+                    else latencies[latencyNext] = micros;
+                    latencyNext = (latencyNext + 1) % RSA_SERVICE_LATENCY_WINDOW;
+                }
+                requests += batch.size();
+                ++batches;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                for (size_t i = 0; i < batch.size(); ++i)
+                    batch[i]->done = true;
+            }
+            requestDone.notify_all();
+        }
+    }
+
+    // Обслуживает одно подключение: запросы выполняются по очереди
+    void connection(int fd) {
+        string body;
+        while (RSA_Service_ReadFrame(fd, body)) {
+            uint8_t op = body.empty() ? 0 : (uint8_t)body[0];
+            string response;
+            if (op == RSA_OP_STATS) {
+                response = RSA_Service_Pack(0, vector<string>(1, stats()));
+            } else if (op == RSA_OP_SHUTDOWN) {
+                RSA_Service_WriteFrame(fd, RSA_Service_Pack(0, vector<string>()));
+                char wake = 1;
+                if (::write(wakePipe[1], &wake, 1) != 1) {}
+                break;
+            } else {
+                Request request;
+                request.body.swap(body);
+                request.start = std::chrono::steady_clock::now();
+                request.done = false;
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queue.push_back(&request);
+                queueReady.notify_one();
+                requestDone.wait(lock, [&]() { return request.done; });
+                response.swap(request.response);
+            }
+            if (!RSA_Service_WriteFrame(fd, response)) break;
+        }
+        std::unique_lock<std::mutex> lock(clientsMutex);
+        clients.erase(fd);
+        ::close(fd);
+        // Поток отсоединен: serve будится только после его завершения
+        if (clients.empty()) std::notify_all_at_thread_exit(clientsDone, std::move(lock));
+    }
+};
+
+// ===== Клиент =====
+
+class RSA_ServiceClient {
+    int fd;
+
+public:
+    explicit RSA_ServiceClient(const string& socketPath) {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path))
+            throw("Error: socket path is too long");
+        strcpy(addr.sun_path, socketPath.c_str());
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw("Error: cannot connect to RSA service");
+        }
+    }
+
+    ~RSA_ServiceClient() { ::close(fd); }
+
+    RSA_ServiceClient(const RSA_ServiceClient&) = delete;
+    RSA_ServiceClient& operator=(const RSA_ServiceClient&) = delete;
+
+    // Отправляет запрос; false - ошибка сервиса, текст в result[0]
+    bool call(uint8_t op, const vector<string>& fields, vector<string>& result) {
+        string body;
+        uint8_t status;
+        if (!RSA_Service_WriteFrame(fd, RSA_Service_Pack(op, fields)) ||
+            !RSA_Service_ReadFrame(fd, body) || !RSA_Service_Unpack(body, status, result))
+            throw("Error: RSA service connection failed");
+        return status == 0;
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+// Подпись RSA и пакетная проверка подписей.
+//
+// Как и шифрование в RSA.h, подпись "учебная": подписывается представитель
+// сообщения m < n (хеширование и дополнение - забота вызывающего).
+//   подпись:  s = m^d mod n       (по CRT с загруженным RSAPrivateKey)
+//   проверка: s^e mod n == m
+// Проверка выполняется гораздо чаще подписи, поэтому открытый ключ
+// разбирает экспоненту один раз: для e = 2^k + 1 (3, 5, 17, 257, 65537)
+// используется цепочка из k возведений в квадрат и одного умножения.
+// Для пакетной проверки собственным ядром ключ хранит постоянные
+// Монтгомери модуля n, общие для всех подписей пакета.
+#include "RSA.h"
+
+// Открытый ключ с подготовленной экспонентой
+struct RSAPublicKey {
+    BigInt n, e;
+    int fermatShift;               // k, если e = 2^k + 1, иначе -1
+    RSAExponentWindows eWindows;   // e, разбитая на окна (для прочих e)
+    ModExpLimbs eLimbs;            // e в лимбах для дорожек Монтгомери
+    ModExpModulus nMontgomery;     // R^2 mod n и n0inv (пусто, если n не годится)
+};
+
+inline RSAPublicKey RSA_Load_PublicKey(const BigInt& n, const BigInt& e) {
+    RSAPublicKey key;
+    key.n = n;
+    key.e = e;
+    key.fermatShift = -1;
+    const std::vector<uint8_t> bits = ToBitsBE(e);
+    key.eWindows = RecodeExponent(bits, 5);
+
+    // e = 2^k + 1: единица, k-1 нулей, единица
+    size_t ones = 0;
+    for (size_t i = 0; i < bits.size(); ++i)
+        ones += bits[i];
+    if (bits.size() >= 2 && ones == 2 && bits.back() == 1)
+        key.fermatShift = (int)bits.size() - 1;
+
+#ifndef BIGINT_BACKEND_GMP
+    const ModExpLimbs nLimbs = ModExp_ToLimbs(n);
+    key.eLimbs = ModExp_ToLimbs(e);
+    if (n > BigInt("1") && (nLimbs[0] & 1))
+        key.nMontgomery = ModExpModulus(nLimbs);
+#endif
+    return key;
+}
+
+// s^e mod n по открытому ключу
+inline BigInt RSA_Public_Op(const BigInt& s, const RSAPublicKey& key) {
+    if (key.fermatShift < 0)
+        return ModExp_Windows(s, key.eWindows, key.n);
+
+    // Цепочка сложений для e = 2^k + 1: k квадратов и одно умножение
+    const BigInt base = s % key.n;
+    BigInt result = base;
+    for (int i = 0; i < key.fermatShift; ++i)
+        result = (result * result) % key.n;
+    return (result * base) % key.n;
+}
+
+// Подпись представителя сообщения m < n
+inline BigInt RSA_Sign(const BigInt& m, const RSAPrivateKey& key) {
+    TRACE_SPAN("rsa.sign", "rsa");
+    if (m >= key.n)
+        throw("Error: Message is too large for the modulus!");
+    return RSA_Decrypt_One_CRT(m, key);
+}
+
+// Проверка одной подписи
+inline bool RSA_Verify(const BigInt& m, const BigInt& s, const RSAPublicKey& key) {
+    TRACE_SPAN("rsa.verify", "rsa");
+    if (m >= key.n || s >= key.n)
+        return false;
+    return RSA_Public_Op(s, key) == m;
+}
+
+// Пакетная проверка, пакет распределяется по threads потокам (0 - по числу ядер).
+// Собственное ядро возводит подписи в степень e группами по MODEXP_LANES
+// в дорожках Монтгомери с общим подготовленным модулем ключа; с GMP
+// (или при чётном n) каждая подпись проверяется отдельно
+inline vector<bool> RSA_Verify_Batch(const vector<BigInt>& m, const vector<BigInt>& s,
+                                     const RSAPublicKey& key, unsigned threads = 0) {
+    TRACE_SPAN("rsa.verify.batch", "rsa");
+    if (m.size() != s.size())
+        throw("Error: number of messages and signatures differ");
+    vector<char> ok(m.size(), 0);  // vector<bool> нельзя писать из разных потоков
+#ifndef BIGINT_BACKEND_GMP
+    if (key.nMontgomery.size() > 0) {
+        const size_t lanes = MODEXP_LANES;
+        RSA_ParallelFor((m.size() + lanes - 1) / lanes, threads, [&](size_t group) {
+            vector<size_t> indices;
+            vector<BigInt> bases;
+            for (size_t i = group * lanes; i < m.size() && i < (group + 1) * lanes; ++i)
+                if (m[i] < key.n && s[i] < key.n) {
+                    indices.push_back(i);
+                    bases.push_back(s[i]);
+                }
+            if (indices.empty())
+                return;
+            const vector<BigInt> powers = ModExp_Batch_Prepared(bases,
+                vector<const ModExpLimbs*>(bases.size(), &key.eLimbs),
+                vector<const ModExpModulus*>(bases.size(), &key.nMontgomery));
+            for (size_t k = 0; k < indices.size(); ++k)
+                ok[indices[k]] = powers[k] == m[indices[k]];
+        });
+        return vector<bool>(ok.begin(), ok.end());
+    }
+#endif
+    RSA_ParallelFor(m.size(), threads, [&](size_t i) {
+        ok[i] = RSA_Verify(m[i], s[i], key);
+    });
+    return vector<bool>(ok.begin(), ok.end());
+}
+
+// Скрининг (Bellare, Garay, Rabin): проверяет (s_1 * ... * s_k)^e == m_1 * ... * m_k
+// одним возведением в степень на весь пакет.
+// Слабее поштучной проверки: перестановка множителей между подписями
+// пакета не обнаруживается, поэтому скрининг подходит для фильтрации
+// потока, а при отказе виновные находятся через RSA_Verify_Batch
+inline bool RSA_Screen_Batch(const vector<BigInt>& m, const vector<BigInt>& s,
+                             const RSAPublicKey& key) {
+    TRACE_SPAN("rsa.verify.screen", "rsa");
+    if (m.size() != s.size())
+        throw("Error: number of messages and signatures differ");
+    BigInt mProduct("1"), sProduct("1");
+    for (size_t i = 0; i < m.size(); ++i) {
+        if (m[i] >= key.n || s[i] >= key.n || Null(s[i]))
+            return false;
+        mProduct = (mProduct * m[i]) % key.n;
+        sProduct = (sProduct * s[i]) % key.n;
+    }
+    return RSA_Public_Op(sProduct, key) == mProduct;
+}
@@ -0,0 +1,264 @@
+#pragma once
+// Потоковое шифрование и дешифрование файлов произвольного размера.
+// Данные проходят конвейер из трёх стадий: поток чтения -> вычисление
+// (блоки пакета распределяются по потокам RSA_ParallelFor) -> поток записи.
+// Между стадиями стоят очереди ограниченной длины, поэтому в памяти
+// находится не больше 2 * queueDepth + 1 пакетов независимо от размера входа.
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include "RSA.h"
+
+// Параметры конвейера
+struct RSA_StreamOptions {
+    unsigned threads;    // Потоков вычисления (0 - по числу ядер)
+    size_t batchBlocks;  // Блоков в одном пакете
+    size_t queueDepth;   // Пакетов в очереди между стадиями
+
+    RSA_StreamOptions() : threads(0), batchBlocks(256), queueDepth(4) {}
+};
+
+// Очередь ограниченной длины между стадиями конвейера.
+// После close() push ничего не добавляет, а pop отдаёт оставшиеся элементы
+// и затем возвращает false
+template <typename T>
+class RSA_BoundedQueue {
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+
+public:
+    explicit RSA_BoundedQueue(size_t capacity)
+        : capacity(capacity ? capacity : 1), closed(false) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&]() { return closed || items.size() < capacity; });
+        if (closed) return;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&]() { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+// Конвейер: read(batch) заполняет пакет (пустой пакет - конец входа),
+// compute(in) преобразует один блок, write(batch) выводит готовый пакет
+// в исходном порядке. При ошибке в любой стадии остальные стадии
+// останавливаются, а исключение пробрасывается вызывающему.
+// Возвращает число обработанных блоков
+template <typename Reader, typename Compute, typename Writer>
+inline uint64_t RSA_RunPipeline(const RSA_StreamOptions& options,
+                                Reader read, Compute compute, Writer write) {
+    RSA_BoundedQueue<vector<string> > input(options.queueDepth);
+    RSA_BoundedQueue<vector<string> > output(options.queueDepth);
+    std::atomic<bool> failed(false);
+    std::exception_ptr readError, computeError, writeError;
+
+    std::thread reader([&]() {
+        try {
+            while (!failed) {
+                vector<string> batch;
+                read(batch);
+                if (batch.empty()) break;
+                input.push(std::move(batch));
+            }
+        } catch (...) {
+            readError = std::current_exception();
+            failed = true;
+        }
+        input.close();
+    });
+
+    std::thread writer([&]() {
+        try {
+            vector<string> batch;
+            while (output.pop(batch))
+                write(batch);
+        } catch (...) {
+            writeError = std::current_exception();
+            failed = true;
+            input.close();
+        }
+        output.close();
+    });
+
+    uint64_t blocks = 0;
+    try {
+        vector<string> batch;
+        while (!failed && input.pop(batch)) {
+            TRACE_SPAN("rsa.stream.batch", "rsa");
+            vector<string> result(batch.size());
+            RSA_ParallelFor(batch.size(), options.threads, [&](size_t i) {
+                result[i] = compute(batch[i]);
+            });
+            blocks += batch.size();
+            output.push(std::move(result));
+        }
+    } catch (...) {
+        computeError = std::current_exception();
+        failed = true;
+        input.close();
+    }
+    output.close();
+    reader.join();
+    writer.join();
+
+    if (readError) std::rethrow_exception(readError);
+    if (computeError) std::rethrow_exception(computeError);
+    if (writeError) std::rethrow_exception(writeError);
+    return blocks;
+}
+
+// Число блоков шифротекста для входа заданного размера
+inline uint64_t RSA_StreamBlockCount(uint64_t bytes, const BigInt& n) {
+    size_t blockSize = GetMaxMessageSize(n);
+    if (blockSize == 0) return 0;
+    return (bytes + blockSize - 1) / blockSize;
+}
+
+// Длина последнего блока открытого текста в байтах (0 - блоков нет)
+inline size_t RSA_StreamLastBlockBytes(uint64_t bytes, const BigInt& n) {
+    size_t blockSize = GetMaxMessageSize(n);
+    if (blockSize == 0 || bytes == 0) return 0;
+    return (size_t)((bytes - 1) % blockSize + 1);
+}
+
+// Строка заголовка cipher.txt: число блоков и длина последнего блока
+inline void RSA_WriteStreamHeader(std::ostream& out, uint64_t bytes, const BigInt& n) {
+    out << RSA_StreamBlockCount(bytes, n) << " " << RSA_StreamLastBlockBytes(bytes, n) << "\n";
+    if (!out) throw("Error: cannot write ciphertext stream");
+}
+
+// Разбор строки заголовка. В старых файлах длины последнего блока нет,
+// тогда lastBlockBytes = 0 (ведущие нулевые байты блока не восстанавливаются)
+inline void RSA_ParseStreamHeader(const string& line, uint64_t& blocks, size_t& lastBlockBytes) {
+    std::istringstream header(line);
+    if (!(header >> blocks))
+        throw("Error: cannot read number of blocks");
+    if (!(header >> lastBlockBytes))
+        lastBlockBytes = 0;
+}
+
+// Шифрует весь поток in (читается блоками по GetMaxMessageSize(n) байт)
+// и пишет в out по одному десятичному блоку на строку - в том же виде,
+// что и блоки cipher.txt (строку заголовка пишет вызывающий,
+// см. RSA_WriteStreamHeader)
+inline uint64_t RSA_Encrypt_Stream(std::istream& in, std::ostream& out,
+                                   const BigInt& n, const BigInt& e,
+                                   const RSA_StreamOptions& options = RSA_StreamOptions()) {
+    TRACE_SPAN("rsa.encrypt", "rsa");
+    const size_t blockSize = GetMaxMessageSize(n);
+    if (blockSize == 0)
+        throw("Error: n is too small to encrypt even one character!");
+    const RSAExponentWindows eWindows = RecodeExponent(ToBitsBE(e), 5);
+    const size_t batchBlocks = options.batchBlocks ? options.batchBlocks : 1;
+
+    string buffer(blockSize * batchBlocks, '\0');
+    return RSA_RunPipeline(options,
+        [&](vector<string>& batch) {
+            in.read(&buffer[0], buffer.size());
+            size_t got = (size_t)in.gcount();
+            if (in.bad()) throw("Error: cannot read plaintext stream");
+            for (size_t i = 0; i < got; i += blockSize)
+                batch.push_back(buffer.substr(i, min(blockSize, got - i)));
+        },
+        [&](const string& chunk) {
+            // Блок короче blockSize байт всегда меньше n
+            std::ostringstream encrypted;
+            encrypted << ModExp_Windows(StringToBigInt(chunk), eWindows, n);
+            return encrypted.str();
+        },
+        [&](const vector<string>& batch) {
+            for (size_t i = 0; i < batch.size(); ++i)
+                out << batch[i] << '\n';
+            if (!out) throw("Error: cannot write ciphertext stream");
+        });
+}
+
+// Вывод расшифрованных блоков: все блоки, кроме последнего, дополняются
+// ведущими нулевыми байтами до размера блока, последний - до lastBlockBytes,
+// поэтому двоичные данные восстанавливаются точно. При lastBlockBytes = 0
+// (длина неизвестна) ведущие нулевые байты последнего блока,
+// как и в RSA_Decrypt_Block, теряются
+struct RSA_PlaintextWriter {
+    std::ostream& out;
+    size_t blockSize;
+    size_t lastBlockBytes;
+    string pending;  // Последний блок придерживается до конца потока
+    bool hasPending;
+
+    RSA_PlaintextWriter(std::ostream& out, size_t blockSize, size_t lastBlockBytes = 0)
+        : out(out), blockSize(blockSize), lastBlockBytes(lastBlockBytes), hasPending(false) {}
+
+    void write(const vector<string>& batch) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (hasPending) {
+                if (pending.size() < blockSize)
+                    out << string(blockSize - pending.size(), '\0');
+                out << pending;
+            }
+            pending = batch[i];
+            hasPending = true;
+        }
+        if (!out) throw("Error: cannot write plaintext stream");
+    }
+
+    void finish() {
+        if (hasPending) {
+            if (lastBlockBytes) {
+                if (pending.size() > lastBlockBytes)
+                    throw("Error: last block is longer than the header says");
+                out << string(lastBlockBytes - pending.size(), '\0');
+            }
+            out << pending;
+        }
+        hasPending = false;
+        if (!out) throw("Error: cannot write plaintext stream");
+    }
+};
+
+// Дешифрует поток десятичных блоков (по одному на строку, строка заголовка
+// должна быть уже прочитана, lastBlockBytes - из нее) и пишет исходные байты в out
+inline uint64_t RSA_Decrypt_Stream(std::istream& in, std::ostream& out,
+                                   const RSAPrivateKey& key, size_t lastBlockBytes = 0,
+                                   const RSA_StreamOptions& options = RSA_StreamOptions()) {
+    TRACE_SPAN("rsa.decrypt", "rsa");
+    const size_t blockSize = GetMaxMessageSize(key.n);
+    const size_t batchBlocks = options.batchBlocks ? options.batchBlocks : 1;
+
+    RSA_PlaintextWriter writer(out, blockSize, lastBlockBytes);
+    uint64_t blocks = RSA_RunPipeline(options,
+        [&](vector<string>& batch) {
+            string line;
+            while (batch.size() < batchBlocks && getline(in, line)) {
+                if (!line.empty() && line[line.size() - 1] == '\r')
+                    line.erase(line.size() - 1);
+                if (!line.empty()) batch.push_back(line);
+            }
+            if (in.bad()) throw("Error: cannot read ciphertext stream");
+        },
+        [&](const string& block) {
+            return BigIntToString(RSA_Decrypt_One_CRT(BigInt(block), key));
+        },
+        [&](const vector<string>& batch) { writer.write(batch); });
+    writer.finish();
+    return blocks;
+}
@@ -1,8 +1,30 @@
 ﻿/*# Compile
-g++ -std=c++11 -pthread -I. -o rsa ZI_LR2.cpp
+g++ -std=c++11 -pthread -I. -I../common -o rsa ZI_LR2.cpp
+# Compile with GMP arithmetic
+g++ -std=c++11 -pthread -I. -I../common -DBIGINT_BACKEND_GMP -o rsa ZI_LR2.cpp -lgmpxx -lgmp
 
 # Run
 ./rsa
+# Run in streaming mode (whole plaintext file, constant memory, no per-block output)
+./rsa --stream
+# Same with the binary ciphertext container cipher.bin instead of cipher.txt
+./rsa --stream --binary
+# Convert an existing cipher.txt to cipher.bin
+./rsa --convert
+# Round-trip checks for inputs with leading zero bytes in the last block
+./rsa --self-test
+# Same with hybrid RSA-KEM + ChaCha20 encryption into cipher.hyb (for large files)
+./rsa --stream --hybrid
+# Save the key computed from p and q to key.bin, then stream with it
+./rsa --save-key
+./rsa --stream --key key.bin
+# Import decimal primes into the binary prime store primes.store,
+# then save a key made of two unused 1024-bit primes from it
+./rsa --import gen_primes/primes_lit.txt
+./rsa --save-key --store primes.store --bits 1024
+# Run as a service on a Unix socket, then load it from a local client
+./rsa --serve --key key.bin &
+./rsa --client --shutdown
 */
 
 #include <iostream>
@@ -10,10 +32,19 @@ g++ -std=c++11 -pthread -I. -o rsa ZI_LR2.cpp
 #include <string>
 #include <vector>
 #include <sstream>
+#include <chrono>
+#include <iomanip>
 #include <locale.h>
 
 #include "Prime.h"
 #include "RSA.h"
+#include "RSA_Container.h"
+#include "RSA_Hybrid.h"
+#include "RSA_KeyFile.h"
+#include "RSA_PrimeStore.h"
+#ifndef _WIN32
+#include "RSA_Service.h"
+#endif
 
 using namespace std;
 
@@ -93,7 +124,371 @@ static bool read_ciphertext(const string& path, vector<string>& out) {
     return true;
 }
 
-int main() {
+// Ключ из двоичного файла key_file, а если он не задан - из p и q
+static bool load_key(const string& p_file, const string& q_file, const string& key_file,
+                     RSAPrivateKey& key, BigInt& e) {
+    if (!key_file.empty()) {
+        cout << "1. Loading key from " << key_file << "..." << endl;
+        try {
+            key = RSA_Read_KeyFile(key_file, e);
+        } catch (const char* msg) {
+            cerr << msg << ": " << key_file << endl;
+            return false;
+        }
+        return true;
+    }
+
+    cout << "1. Reading key files..." << endl;
+    string p_str, q_str;
+    if (!read_line_trim(p_file, p_str) || !read_line_trim(q_file, q_str))
+        return false;
+    BigInt p(p_str), q(q_str);
+
+    cout << "\n2. Generating RSA keys..." << endl;
+    BigInt n, d;
+    RSA_Initialize_FromPQ(p, q, n, e, d);
+    key = RSA_Load_PrivateKey(p, q, d);
+    return true;
+}
+
+// Скорость обработки bytes байт с момента started
+static void print_throughput(uint64_t bytes, chrono::steady_clock::time_point started) {
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cout << "   " << fixed << setprecision(1) << seconds * 1000 << " ms, "
+         << (seconds > 0 ? bytes / seconds / (1 << 20) : 0.0) << " MB/s" << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+// Потоковый режим: шифрует весь файл plaintext.txt (любого размера)
+// в cipher.txt (binary - в двоичный контейнер cipher.bin, hybrid - гибридным
+// шифрованием RSA-KEM + ChaCha20 в cipher.hyb), дешифрует его в decrypt.txt
+// и сравнивает файлы.
+// Блоки не выводятся на консоль, память не зависит от размера файла
+static int run_stream(const string& p_file, const string& q_file, const string& key_file,
+                      const string& pt_file, const string& ct_file, const string& dt_file,
+                      bool binary, bool hybrid) {
+    RSAPrivateKey key;
+    BigInt e;
+    if (!load_key(p_file, q_file, key_file, key, e))
+        return 1;
+    const BigInt& n = key.n;
+
+    try {
+        cout << "\n3. Encrypting " << pt_file << " -> " << ct_file << "..." << endl;
+        ifstream fin_pt(pt_file, ios::binary);
+        ofstream fout_ct(ct_file, ios::binary);
+        if (!fin_pt || !fout_ct) {
+            cerr << "Cannot open " << pt_file << " or " << ct_file << endl;
+            return 1;
+        }
+        fin_pt.seekg(0, ios::end);
+        uint64_t bytes = (uint64_t)fin_pt.tellg();
+        fin_pt.seekg(0, ios::beg);
+        uint64_t blocks;
+        auto started = chrono::steady_clock::now();
+        if (hybrid) {
+            RSA_Hybrid_Encrypt(fin_pt, fout_ct, RSA_Load_PublicKey(n, e));
+            blocks = 1;
+        } else if (binary) {
+            blocks = RSA_Encrypt_Container(fin_pt, fout_ct, bytes, n, e);
+        } else {
+            // Формат cipher.txt: число блоков и длина последнего блока, затем блоки по строкам
+            RSA_WriteStreamHeader(fout_ct, bytes, n);
+            blocks = RSA_Encrypt_Stream(fin_pt, fout_ct, n, e);
+        }
+        fout_ct.close();
+        cout << "   " << bytes << " bytes, " << blocks << " blocks" << endl;
+        if (hybrid) print_throughput(bytes, started);
+
+        cout << "\n4. Decrypting " << ct_file << " -> " << dt_file << "..." << endl;
+        ofstream fout_dt(dt_file, ios::binary);
+        started = chrono::steady_clock::now();
+        if (hybrid) {
+            ifstream fin_ct(ct_file, ios::binary);
+            RSA_Hybrid_Decrypt(fin_ct, fout_dt, key);
+        } else if (binary) {
+            RSA_ContainerFile container(ct_file);
+            RSA_Decrypt_Container(container, fout_dt, key);
+        } else {
+            ifstream fin_ct(ct_file, ios::binary);
+            string header;
+            if (!fin_ct || !fout_dt || !getline(fin_ct, header)) {
+                cerr << "Cannot open " << ct_file << " or " << dt_file << endl;
+                return 1;
+            }
+            uint64_t count;
+            size_t lastBlockBytes;
+            RSA_ParseStreamHeader(header, count, lastBlockBytes);
+            RSA_Decrypt_Stream(fin_ct, fout_dt, key, lastBlockBytes);
+        }
+        fout_dt.close();
+        if (hybrid) print_throughput(bytes, started);
+    } catch (const char* msg) {
+        cerr << msg << endl;
+        return 1;
+    }
+
+    cout << "\n5. Verifying decryption..." << endl;
+    ifstream a(pt_file, ios::binary), b(dt_file, ios::binary);
+    vector<char> bufA(1 << 16), bufB(1 << 16);
+    bool same = true;
+    while (same && (a || b)) {
+        a.read(bufA.data(), bufA.size());
+        b.read(bufB.data(), bufB.size());
+        same = a.gcount() == b.gcount() &&
+               equal(bufA.begin(), bufA.begin() + a.gcount(), bufB.begin());
+        if (a.gcount() == 0) break;
+    }
+    if (same) {
+        cout << "\n✓ SUCCESS: Original and recovered files match!" << endl;
+    } else {
+        cout << "\n✗ FAILURE: Original and recovered files DO NOT match!" << endl;
+    }
+
+    cout << "\n=== Program completed ===" << endl;
+    return same ? 0 : 1;
+}
+
+// Проверка восстановления входов, у которых последний блок начинается
+// с нулевых байтов (или целиком из них): текстовый поток шифруется
+// и дешифруется в памяти, контейнер (напрямую и из текстового шифротекста)
+// проходит через временный файл bin_file
+static int run_self_test(const string& p_file, const string& q_file, const string& bin_file) {
+    RSAPrivateKey key;
+    BigInt e;
+    if (!load_key(p_file, q_file, "", key, e))
+        return 1;
+    const size_t blockSize = GetMaxMessageSize(key.n);
+    const string full(blockSize, 'x');
+    const vector<string> inputs = {
+        "",
+        string(2, '\0'),
+        full + string(2, '\0') + "y",
+        full + string(3, '\0'),
+        string(blockSize, '\0'),
+        string(2 * blockSize + 1, '\0') + "z",
+    };
+
+    cout << "\n3. Round-trip of " << inputs.size() << " inputs, block " << blockSize << " bytes..." << endl;
+    int failures = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const string& input = inputs[i];
+        try {
+            istringstream plain(input);
+            ostringstream cipher;
+            RSA_WriteStreamHeader(cipher, input.size(), key.n);
+            RSA_Encrypt_Stream(plain, cipher, key.n, e);
+
+            istringstream fin_ct(cipher.str());
+            string header;
+            getline(fin_ct, header);
+            uint64_t count;
+            size_t lastBlockBytes;
+            RSA_ParseStreamHeader(header, count, lastBlockBytes);
+            ostringstream recovered;
+            RSA_Decrypt_Stream(fin_ct, recovered, key, lastBlockBytes);
+            if (recovered.str() != input) {
+                cout << "   text stream: input " << i << " (" << input.size() << " bytes) does not match" << endl;
+                ++failures;
+            }
+
+            for (int converted = 0; converted < 2; ++converted) {
+                {
+                    ofstream fout_bin(bin_file, ios::binary);
+                    if (converted) {
+                        istringstream text(cipher.str());
+                        RSA_Container_FromText(text, fout_bin, key.n);
+                    } else {
+                        istringstream again(input);
+                        RSA_Encrypt_Container(again, fout_bin, input.size(), key.n, e);
+                    }
+                }
+                ostringstream unpacked;
+                {
+                    RSA_ContainerFile container(bin_file);
+                    RSA_Decrypt_Container(container, unpacked, key);
+                }
+                if (unpacked.str() != input) {
+                    cout << "   container" << (converted ? " from text" : "") << ": input " << i
+                         << " (" << input.size() << " bytes) does not match" << endl;
+                    ++failures;
+                }
+            }
+        } catch (const char* msg) {
+            cerr << msg << endl;
+            ++failures;
+        }
+    }
+    remove(bin_file.c_str());
+    cout << (failures ? "FAILURE: " + to_string(failures) + " checks failed" : "SUCCESS: all checks passed") << endl;
+    return failures ? 1 : 0;
+}
+
+// Преобразование cipher.txt в двоичный контейнер cipher.bin
+static int run_convert(const string& p_file, const string& q_file,
+                       const string& ct_file, const string& bin_file) {
+    string p_str, q_str;
+    if (!read_line_trim(p_file, p_str) || !read_line_trim(q_file, q_str))
+        return 1;
+    BigInt n = BigInt(p_str) * BigInt(q_str);
+
+    ifstream fin_ct(ct_file, ios::binary);
+    ofstream fout_bin(bin_file, ios::binary);
+    if (!fin_ct || !fout_bin) {
+        cerr << "Cannot open " << ct_file << " or " << bin_file << endl;
+        return 1;
+    }
+    try {
+        uint64_t blocks = RSA_Container_FromText(fin_ct, fout_bin, n);
+        fout_bin.close();
+        fin_ct.clear();
+        cout << "   " << blocks << " blocks: " << ct_file << " " << fin_ct.seekg(0, ios::end).tellg()
+             << " bytes -> " << bin_file << " " << ifstream(bin_file, ios::binary | ios::ate).tellg()
+             << " bytes" << endl;
+    } catch (const char* msg) {
+        cerr << msg << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Сохранение ключа, вычисленного из p и q, в двоичный файл.
+// Если задано хранилище store_file, p и q - два неиспользованных простых
+// битности bits из него
+static int run_save_key(const string& p_file, const string& q_file, const string& key_file,
+                        const string& store_file, uint32_t bits) {
+    RSAPrivateKey key;
+    BigInt e;
+    if (store_file.empty()) {
+        if (!load_key(p_file, q_file, "", key, e))
+            return 1;
+    } else {
+        cout << "1. Taking " << bits << "-bit primes from " << store_file << "..." << endl;
+        BigInt p, q, n, d;
+        try {
+            RSA_PrimeStore store(store_file);
+            if (!store.take(bits, p) || !store.take(bits, q)) {
+                cerr << "Not enough unused " << bits << "-bit primes in: " << store_file << endl;
+                return 1;
+            }
+        } catch (const char* msg) {
+            cerr << msg << ": " << store_file << endl;
+            return 1;
+        }
+        cout << "\n2. Generating RSA keys..." << endl;
+        RSA_Initialize_FromPQ(p, q, n, e, d);
+        key = RSA_Load_PrivateKey(p, q, d);
+    }
+    try {
+        RSA_Save_KeyFile(key_file, key, e);
+    } catch (const char* msg) {
+        cerr << msg << ": " << key_file << endl;
+        return 1;
+    }
+    cout << "   Key written to " << key_file << endl;
+    return 0;
+}
+
+// Перенос простых из текстового файла (по числу в строке) в хранилище
+static int run_import(const string& txt_file, const string& store_file) {
+    ifstream fin(txt_file);
+    if (!fin) {
+        cerr << "Cannot open file: " << txt_file << endl;
+        return 1;
+    }
+    size_t count = 0;
+    try {
+        RSA_PrimeStoreWriter writer(store_file);
+        string line;
+        while (getline(fin, line)) {
+            size_t l = line.find_first_not_of(" \t\r\n");
+            if (l == string::npos) continue;
+            size_t r = line.find_last_not_of(" \t\r\n");
+            writer.append(BigInt(line.substr(l, r - l + 1)));
+            ++count;
+        }
+    } catch (const char* msg) {
+        cerr << msg << ": " << store_file << endl;
+        return 1;
+    }
+    cout << "   " << count << " primes from " << txt_file << " appended to " << store_file << endl;
+    return 0;
+}
+
+#ifndef _WIN32
+// Сервис: ключ загружается один раз, запросы принимаются на Unix-сокете
+static int run_serve(const string& p_file, const string& q_file, const string& key_file,
+                     const string& socket_file) {
+    RSAPrivateKey key;
+    BigInt e;
+    if (!load_key(p_file, q_file, key_file, key, e))
+        return 1;
+    RSA_Service service(key, e);
+    cout << "\nServing on " << socket_file << " (SHUTDOWN request stops the service)" << endl;
+    try {
+        service.serve(socket_file);
+    } catch (const char* msg) {
+        cerr << msg << ": " << socket_file << endl;
+        return 1;
+    }
+    cout << "Latency: " << service.stats() << endl;
+    return 0;
+}
+
+// Локальный клиент: несколько потоков шлют encrypt/decrypt/sign/verify
+// и проверяют результаты; выводятся задержки клиента и сервиса
+static int run_client(const string& socket_file, bool shutdown) {
+    const int threads = 4, rounds = 50;
+    vector<double> latencies;
+    std::mutex latenciesMutex;
+    std::atomic<int> failures(0);
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.push_back(thread([&, t]() {
+            try {
+                RSA_ServiceClient client(socket_file);
+                vector<double> local;
+                for (int i = 0; i < rounds; ++i) {
+                    const string message = "msg " + to_string(t) + "/" + to_string(i);
+                    vector<string> c, m, s, ok;
+                    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                    bool good = client.call(RSA_OP_ENCRYPT, vector<string>(1, message), c) &&
+                                client.call(RSA_OP_DECRYPT, c, m) && m[0] == message &&
+                                client.call(RSA_OP_SIGN, vector<string>(1, message), s) &&
+                                client.call(RSA_OP_VERIFY, {message, s[0]}, ok) && ok[0] == "\1";
+                    local.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / 4);
+                    if (!good) ++failures;
+                }
+                std::lock_guard<std::mutex> lock(latenciesMutex);
+                latencies.insert(latencies.end(), local.begin(), local.end());
+            } catch (const char* msg) {
+                cerr << msg << endl;
+                ++failures;
+            }
+        }));
+    }
+    for (size_t t = 0; t < pool.size(); ++t)
+        pool[t].join();
+
+    try {
+        RSA_ServiceClient client(socket_file);
+        vector<string> result;
+        client.call(RSA_OP_STATS, vector<string>(), result);
+        cout << "Client latency (per request): " << RSA_Percentiles(latencies) << endl;
+        cout << "Service latency: " << result[0] << endl;
+        if (shutdown)
+            client.call(RSA_OP_SHUTDOWN, vector<string>(), result);
+    } catch (const char* msg) {
+        cerr << msg << endl;
+        return 1;
+    }
+    cout << (failures ? "FAILURE: " + to_string(failures) + " checks failed" : "SUCCESS: all checks passed") << endl;
+    return failures ? 1 : 0;
+}
+#endif
+
+int main(int argc, char** argv) {
     setlocale(LC_ALL, "Ru");
     cout << "=== RSA Encryption/Decryption Program ===" << endl;
     
@@ -105,6 +500,45 @@ int main() {
     // Выходные файлы
     const string ct_file = "cipher.txt";
     const string dt_file = "decrypt.txt";
+    const string bin_file = "cipher.bin";
+    const string hyb_file = "cipher.hyb";
+    
+    const string default_key_file = "key.bin";
+    const string default_store_file = "primes.store";
+    const string socket_file = "rsa.sock";
+    
+    // Режим и флаги разбираются целиком, порядок аргументов не важен
+    string mode, key_file, store_file, import_file;
+    uint32_t bits = 1024;
+    bool binary = false, hybrid = false, shutdown = false;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if (arg == "--binary") binary = true;
+        else if (arg == "--hybrid") hybrid = true;
+        else if (arg == "--shutdown") shutdown = true;
+        else if (arg == "--key" && i + 1 < argc) key_file = argv[++i];
+        else if (arg == "--store" && i + 1 < argc) store_file = argv[++i];
+        else if (arg == "--bits" && i + 1 < argc) bits = (uint32_t)atoi(argv[++i]);
+        else if (arg == "--import" && i + 1 < argc) { mode = arg; import_file = argv[++i]; }
+        else mode = arg;
+    }
+    if (mode == "--stream")
+        return run_stream(p_file, q_file, key_file, pt_file,
+                          hybrid ? hyb_file : binary ? bin_file : ct_file, dt_file, binary, hybrid);
+    if (mode == "--convert")
+        return run_convert(p_file, q_file, ct_file, bin_file);
+    if (mode == "--self-test")
+        return run_self_test(p_file, q_file, "self_test.bin");
+    if (mode == "--save-key")
+        return run_save_key(p_file, q_file, default_key_file, store_file, bits);
+    if (mode == "--import")
+        return run_import(import_file, store_file.empty() ? default_store_file : store_file);
+#ifndef _WIN32
+    if (mode == "--serve")
+        return run_serve(p_file, q_file, key_file, socket_file);
+    if (mode == "--client")
+        return run_client(socket_file, shutdown);
+#endif
     
     cout << "1. Reading input files..." << endl;
     
@@ -175,7 +609,8 @@ int main() {
     cout << "   Ciphertext written to " << ct_file << endl; //" (" << cipher.size() << " blocks)" << endl;
     
     cout << "\n6. Decrypting ciphertext..." << endl;
-    string recovered = RSA_Decrypt_Block(cipher, n, d, p, q);
+    const RSAPrivateKey key = RSA_Load_PrivateKey(p, q, d);
+    string recovered = RSA_Decrypt_Block(cipher, key);
     
     cout << "\n7. Writing decrypted text to file..." << endl;
     ofstream fout_dt(dt_file);
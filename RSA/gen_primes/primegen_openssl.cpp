@@ -8,10 +8,13 @@
 #include <chrono>
 #include <string>
 #include <cstring>
+#include <memory>
 
 #include <openssl/bn.h>
 #include <openssl/rand.h>
 
+#include "../RSA_PrimeStore.h"
+
 static std::string bn_to_dec(const BIGNUM* bn) {
     char* s = BN_bn2dec(bn);
     if (!s) return {};
@@ -31,18 +34,21 @@ static void seed_thread_rng(uint64_t salt) {
 }
 
 // Генерация одного k-битного простого через BN_generate_prime_ex
-static bool generate_prime_bits(int bits, BIGNUM* out, BN_CTX* ctx) {
+// (safe - безопасного: (p-1)/2 тоже простое)
+static bool generate_prime_bits(int bits, bool safe, BIGNUM* out, BN_CTX* ctx) {
     // flags=BN_GENCB_NULL, add=NULL, rem=NULL
     // BN_generate_prime_ex: гарантирует старший бит и нечётность
-    return BN_generate_prime_ex(out, bits, 0, nullptr, nullptr, nullptr) == 1;
+    return BN_generate_prime_ex(out, bits, safe ? 1 : 0, nullptr, nullptr, nullptr) == 1;
 }
 
 struct Job {
     int bits;
+    bool safe;
     std::atomic<int>* need;
     std::atomic<int>* found;
     std::mutex* mx;
     std::ofstream* fout;
+    RSA_PrimeStoreWriter* store;   // Вместо fout, если вывод в хранилище
     std::atomic<bool>* stop;
     uint64_t seed;
 };
@@ -57,11 +63,23 @@ static void worker(Job job) {
     while (!job.stop->load(std::memory_order_relaxed)) {
         if (job.need->load(std::memory_order_relaxed) <= 0) break;
 
-        if (!generate_prime_bits(job.bits, p, ctx)) continue;
+        if (!generate_prime_bits(job.bits, job.safe, p, ctx)) continue;
 
         int prev = job.need->fetch_sub(1);
         if (prev <= 0) break;
 
+        if (job.store) {
+            // Писатель хранилища сам сериализует записи потоков
+            std::vector<uint8_t> bytes(BN_num_bytes(p));
+            BN_bn2bin(p, bytes.data());
+            job.store->append(bytes.data(), bytes.size());
+            int idx = job.found->fetch_add(1) + 1;
+            std::lock_guard<std::mutex> lk(*job.mx);
+            std::cerr << "[ok] prime #" << idx << " (" << job.bits << "-bit)\n";
+            if (job.need->load() <= 0) break;
+            continue;
+        }
+
         std::string s = bn_to_dec(p);
         {
             std::lock_guard<std::mutex> lk(*job.mx);
@@ -89,12 +107,25 @@ int main(int argc, char** argv) {
     if (argc >= 3) count = std::max(1, atoi(argv[2]));
     if (argc >= 4) out = argv[3];
     if (argc >= 5) threads = std::max(1, atoi(argv[4]));
+    const bool safe = argc >= 6 && std::string(argv[5]) == "safe";
 
-    std::cerr << "[cfg] bits=" << bits << ", count=" << count
+    std::cerr << "[cfg] bits=" << bits << (safe ? " (safe)" : "") << ", count=" << count
               << ", threads=" << threads << ", outfile=" << out << "\n";
 
-    std::ofstream fout(out, std::ios::trunc);
-    if (!fout) { std::cerr << "Cannot open output: " << out << "\n"; return 1; }
+    // Файл *.store - двоичное хранилище (дописывается), иначе десятичный текст
+    const std::string store_ext = ".store";
+    const bool to_store = out.size() > store_ext.size() &&
+        out.compare(out.size() - store_ext.size(), store_ext.size(), store_ext) == 0;
+    std::ofstream fout;
+    std::unique_ptr<RSA_PrimeStoreWriter> store;
+    try {
+        if (to_store) store.reset(new RSA_PrimeStoreWriter(out));
+        else fout.open(out, std::ios::trunc);
+    } catch (const char* msg) {
+        std::cerr << msg << ": " << out << "\n";
+        return 1;
+    }
+    if (!to_store && !fout) { std::cerr << "Cannot open output: " << out << "\n"; return 1; }
 
     std::atomic<int> need(count), found(0);
     std::atomic<bool> stop(false);
@@ -106,7 +137,7 @@ int main(int argc, char** argv) {
     uint64_t seed0 = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
 
     for (int i=0;i<threads;i++) {
-        Job j { bits, &need, &found, &mx, &fout, &stop, seed0 ^ (0x9E3779B97F4A7C15ULL * (i+1)) };
+        Job j { bits, safe, &need, &found, &mx, &fout, store.get(), &stop, seed0 ^ (0x9E3779B97F4A7C15ULL * (i+1)) };
         pool.emplace_back(worker, j);
     }
 
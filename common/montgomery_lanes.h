@@ -0,0 +1,283 @@
+#ifndef MONTGOMERY_LANES_H
+#define MONTGOMERY_LANES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Ядро многодорожечного возведения в степень по Монтгомери
+ * (общее для MontgomeryBatch из PZ_3 и ModExp_Batch_Lanes из RSA)
+ *
+ * Обозначения: s - число лимбов модуля, L = LANES - число дорожек,
+ * R = 2^(32 s). Число дорожки l хранится в массиве из s * L элементов:
+ * лимб j - элемент j * L + l, поэтому внутренний цикл умножения проходит
+ * по дорожкам одинаковыми операциями и векторизуется компилятором
+ * (64-битные произведения 32-битных лимбов: pmuludq / vpmuludq).
+ * Показатели обрабатываются общими окнами по WINDOW_BITS бит; у более
+ * коротких показателей старшие окна нулевые.
+ *
+ * Ядро не зависит от BigInt: числа - массивы 32-битных лимбов
+ * (младший лимб первым).
+ */
+class MontgomeryLanes {
+public:
+    typedef std::vector<uint32_t> Limbs;
+
+    static const int LANES = 4;
+    static const int WINDOW_BITS = 4;
+
+    /**
+     * Постоянные одного модуля: значащие лимбы, -n^(-1) mod 2^32 и R^2 mod n.
+     * Считаются один раз и служат всем возведениям по этому модулю
+     * (простые закрытого ключа, модуль открытого ключа)
+     */
+    struct Modulus {
+        Limbs n;
+        uint32_t n0inv;
+        Limbs radix2;
+
+        Modulus() : n0inv(0) {}
+
+        // mod - нечетный и больше 1
+        explicit Modulus(const Limbs& mod)
+            : n(mod.begin(), mod.begin() + significantLimbs(mod)),
+              n0inv(negativeInverse(mod[0])), radix2(squaredRadix(n)) {}
+
+        size_t size() const { return n.size(); }
+    };
+
+    size_t s;
+    std::vector<uint32_t> n;   // модули дорожек
+    uint32_t n0inv[LANES];     // -n^(-1) mod 2^32
+    std::vector<uint64_t> t;   // буфер умножения
+
+    explicit MontgomeryLanes(size_t size) : s(size), n(size * LANES), t((size + 2) * LANES) {}
+
+    // Количество значащих лимбов
+    static size_t significantLimbs(const Limbs& x) {
+        size_t size = x.size();
+        while (size > 0 && x[size - 1] == 0) --size;
+        return size;
+    }
+
+    // -n^(-1) mod 2^32 (итерации Ньютона, n нечетный)
+    static uint32_t negativeInverse(uint32_t n0) {
+        uint32_t inverse = 1;
+        for (int i = 0; i < 5; ++i)
+            inverse *= 2 - n0 * inverse;
+        return 0u - inverse;
+    }
+
+    // Модуль дорожки l (из s лимбов)
+    void setModulus(int l, const Modulus& mod) {
+        const int L = LANES;
+        for (size_t j = 0; j < s; ++j)
+            n[j * L + l] = mod.n[j];
+        n0inv[l] = mod.n0inv;
+    }
+
+    // out = a * b * R^(-1) mod n во всех дорожках (CIOS).
+    // Требуется a * b < n * R; out может совпадать с a или b
+    void mul(const uint32_t* a, const uint32_t* b, uint32_t* out) {
+        const int L = LANES;
+        std::fill(t.begin(), t.end(), 0);
+        uint64_t* T = t.data();
+        const uint32_t* N = n.data();
+
+        for (size_t i = 0; i < s; ++i) {
+            uint64_t carry[L] = {0};
+            const uint32_t* bi = b + i * L;
+            for (size_t j = 0; j < s; ++j) {
+                const uint32_t* aj = a + j * L;
+                uint64_t* tj = T + j * L;
+                for (int l = 0; l < L; ++l) {
+                    uint64_t p = tj[l] + (uint64_t)aj[l] * bi[l] + carry[l];
+                    tj[l] = (uint32_t)p;
+                    carry[l] = p >> 32;
+                }
+            }
+            for (int l = 0; l < L; ++l) {
+                uint64_t p = T[s * L + l] + carry[l];
+                T[s * L + l] = (uint32_t)p;
+                T[(s + 1) * L + l] = p >> 32;
+            }
+
+            // Прибавляем m * n, чтобы младший лимб обнулился, и сдвигаем на лимб
+            uint32_t m[L];
+            for (int l = 0; l < L; ++l) {
+                m[l] = (uint32_t)T[l] * n0inv[l];
+                carry[l] = (T[l] + (uint64_t)m[l] * N[l]) >> 32;
+            }
+            for (size_t j = 1; j < s; ++j) {
+                const uint32_t* nj = N + j * L;
+                uint64_t* tj = T + j * L;
+                for (int l = 0; l < L; ++l) {
+                    uint64_t p = tj[l] + (uint64_t)m[l] * nj[l] + carry[l];
+                    tj[l - L] = (uint32_t)p;
+                    carry[l] = p >> 32;
+                }
+            }
+            for (int l = 0; l < L; ++l) {
+                uint64_t p = T[s * L + l] + carry[l];
+                T[(s - 1) * L + l] = (uint32_t)p;
+                T[s * L + l] = T[(s + 1) * L + l] + (p >> 32);
+            }
+        }
+
+        // Результат меньше 2n: вычитаем n без ветвлений там, где t >= n
+        uint64_t borrow[L] = {0};
+        for (size_t j = 0; j < s; ++j)
+            for (int l = 0; l < L; ++l) {
+                uint64_t d = T[j * L + l] - N[j * L + l] - borrow[l];
+                out[j * L + l] = (uint32_t)d;
+                borrow[l] = (d >> 63) & 1;
+            }
+        for (int l = 0; l < L; ++l) {
+            // Вычитание не нужно, если не было переноса в лимб s и был заем
+            uint32_t keep = (T[s * L + l] == 0 && borrow[l]) ? 0xFFFFFFFFu : 0;
+            for (size_t j = 0; j < s; ++j) {
+                uint32_t& o = out[j * L + l];
+                o = (o & ~keep) | ((uint32_t)T[j * L + l] & keep);
+            }
+        }
+    }
+
+    // R^2 mod n: 64 s удвоений единицы с вычитанием n (n из s значащих лимбов)
+    static Limbs squaredRadix(const Limbs& n) {
+        const size_t s = n.size();
+        Limbs r(s + 1, 0);
+        r[0] = 1;
+        for (size_t bit = 0; bit < 64 * s; ++bit) {
+            uint32_t high = 0;
+            for (size_t j = 0; j <= s; ++j) {
+                uint32_t next = r[j] >> 31;
+                r[j] = (r[j] << 1) | high;
+                high = next;
+            }
+            // r < 2n: сравниваем с n и вычитаем
+            bool greater = r[s] != 0;
+            if (!greater) {
+                greater = true;
+                for (size_t j = s; j-- > 0;) {
+                    if (r[j] != n[j]) { greater = r[j] > n[j]; break; }
+                }
+            }
+            if (greater) {
+                uint64_t borrow = 0;
+                for (size_t j = 0; j < s; ++j) {
+                    uint64_t d = (uint64_t)r[j] - n[j] - borrow;
+                    r[j] = (uint32_t)d;
+                    borrow = (d >> 63) & 1;
+                }
+                r[s] -= (uint32_t)borrow;
+            }
+        }
+        r.pop_back();
+        return r;
+    }
+
+    // Окно показателя с номером window (младшие окна первые)
+    static uint32_t exponentWindow(const Limbs& e, size_t window) {
+        const size_t bit = window * WINDOW_BITS;
+        const size_t limb = bit / 32, shift = bit % 32;
+        if (limb >= e.size()) return 0;
+        uint64_t bits = e[limb];
+        if (limb + 1 < e.size()) bits |= (uint64_t)e[limb + 1] << 32;
+        return (uint32_t)(bits >> shift) & ((1u << WINDOW_BITS) - 1);
+    }
+
+    /**
+     * Группа из LANES возведений: results[l] = bases[l]^exps[l] mod mods[l]
+     * Требования: mods[l] нечетные, больше 1, с одинаковым числом значащих
+     * лимбов; bases[l] < mods[l]
+     */
+    static void modPow(const Limbs* const* bases, const Limbs* const* exps,
+                       const Limbs* const* mods, std::vector<Limbs>& results) {
+        Modulus prepared[LANES];
+        const Modulus* lanes[LANES];
+        for (int l = 0; l < LANES; ++l) {
+            // Дополненная группа повторяет модуль первой дорожки
+            if (l > 0 && mods[l] == mods[0]) prepared[l] = prepared[0];
+            else prepared[l] = Modulus(*mods[l]);
+            lanes[l] = &prepared[l];
+        }
+        modPow(bases, exps, lanes, results);
+    }
+
+    /**
+     * То же по подготовленным модулям одной длины: R^2 mod n и -n^(-1) mod 2^32
+     * берутся из Modulus, а не считаются заново
+     */
+    static void modPow(const Limbs* const* bases, const Limbs* const* exps,
+                       const Modulus* const* mods, std::vector<Limbs>& results) {
+        const int L = LANES;
+        const size_t s = mods[0]->size(), width = s * L;
+        MontgomeryLanes lanes(s);
+        size_t windows = 0;
+        for (int l = 0; l < L; ++l) {
+            lanes.setModulus(l, *mods[l]);
+            size_t limbs = significantLimbs(*exps[l]), bits = 0;
+            if (limbs > 0)
+                for (uint32_t top = (*exps[l])[limbs - 1]; top; top >>= 1) ++bits;
+            bits += limbs > 0 ? (limbs - 1) * 32 : 0;
+            windows = std::max(windows, (bits + WINDOW_BITS - 1) / WINDOW_BITS);
+        }
+
+        // Нужны степени только до наибольшего окна: короткие показатели
+        // (e = 65537 - окна 1, 0, 0, 0, 1) не платят за всю таблицу
+        uint32_t largest = 1;
+        for (size_t w = 0; w < windows; ++w)
+            for (int l = 0; l < L; ++l)
+                largest = std::max(largest, exponentWindow(*exps[l], w));
+
+        // Таблица степеней основания в форме Монтгомери: table[k] = base^k * R mod n
+        const int tableSize = (int)largest + 1;
+        std::vector<uint32_t> table(tableSize * width), radix2(width), operand(width, 0);
+        for (int l = 0; l < L; ++l) {
+            for (size_t j = 0; j < s; ++j)
+                radix2[j * L + l] = mods[l]->radix2[j];
+            const Limbs& base = *bases[l];
+            for (size_t j = 0; j < s && j < base.size(); ++j)
+                operand[j * L + l] = base[j];
+        }
+        lanes.mul(operand.data(), radix2.data(), &table[width]);
+        std::fill(operand.begin(), operand.end(), 0);
+        for (int l = 0; l < L; ++l) operand[l] = 1;
+        lanes.mul(operand.data(), radix2.data(), &table[0]);
+        for (int k = 2; k < tableSize; ++k)
+            lanes.mul(&table[(k - 1) * width], &table[width], &table[k * width]);
+
+        // Слева направо: WINDOW_BITS квадратов, затем умножение на table[окно] своей дорожки
+        // (пропускается, если окно нулевое во всех дорожках)
+        std::vector<uint32_t> acc(table.begin(), table.begin() + width);
+        for (size_t w = windows; w-- > 0;) {
+            if (w + 1 != windows)
+                for (int i = 0; i < WINDOW_BITS; ++i)
+                    lanes.mul(acc.data(), acc.data(), acc.data());
+            bool zero = true;
+            for (int l = 0; l < L; ++l)
+                zero = zero && exponentWindow(*exps[l], w) == 0;
+            if (zero) continue;
+            for (int l = 0; l < L; ++l) {
+                const uint32_t* entry = &table[exponentWindow(*exps[l], w) * width];
+                for (size_t j = 0; j < s; ++j)
+                    operand[j * L + l] = entry[j * L + l];
+            }
+            lanes.mul(acc.data(), operand.data(), acc.data());
+        }
+
+        // Выход из формы Монтгомери: умножение на 1
+        std::fill(operand.begin(), operand.end(), 0);
+        for (int l = 0; l < L; ++l) operand[l] = 1;
+        lanes.mul(acc.data(), operand.data(), acc.data());
+
+        results.assign(L, Limbs(s));
+        for (int l = 0; l < L; ++l)
+            for (size_t j = 0; j < s; ++j)
+                results[l][j] = acc[j * L + l];
+    }
+};
+
+#endif
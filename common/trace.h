@@ -0,0 +1,159 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+/**
+ * Трассировка фаз вычислений в формате Chrome trace-event
+ * (открывается в chrome://tracing и ui.perfetto.dev)
+ *
+ * Включается переменной окружения BIGINT_TRACE=<файл.json>; файл
+ * записывается при завершении программы. Без переменной отрезок
+ * стоит одной проверки флага.
+ *
+ * События копятся в буфере своего потока без блокировок. Мьютекс берется
+ * только при первом событии потока (регистрация буфера) и при записи файла,
+ * поэтому к моменту выхода рабочие потоки должны быть завершены (join).
+ */
+class Trace {
+public:
+    /**
+     * Отрезок трассы: от создания объекта до выхода из области видимости
+     * @param name, category - строковые литералы (указатели сохраняются в буфере)
+     */
+    class Span {
+        const char* name;
+        const char* category;
+        long long start;
+        bool active;
+
+    public:
+        explicit Span(const char* name, const char* category = "bigint")
+            : name(name), category(category), start(0), active(Trace::enabled()) {
+            if (active) start = Trace::now();
+        }
+
+        ~Span() {
+            if (active) Trace::record(name, category, start, Trace::now() - start);
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    };
+
+    /**
+     * Включена ли трассировка (задана ли BIGINT_TRACE)
+     */
+    static bool enabled() {
+        return state().path != nullptr;
+    }
+
+    /**
+     * Наносекунды от первого обращения к трассировке
+     */
+    static long long now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - state().origin).count();
+    }
+
+    /**
+     * Добавляет завершенный отрезок в буфер текущего потока
+     */
+    static void record(const char* name, const char* category, long long start, long long duration) {
+        Event event = {name, category, start, duration};
+        threadBuffer().events.push_back(event);
+    }
+
+    /**
+     * Записывает накопленные события в файл BIGINT_TRACE
+     * (вызывается автоматически при выходе)
+     */
+    static void write() {
+        State& s = state();
+        if (!s.path) return;
+
+        std::lock_guard<std::mutex> lock(s.mutex);
+        FILE* out = std::fopen(s.path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot write trace: %s\n", s.path);
+            return;
+        }
+
+        std::fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+        bool first = true;
+        for (size_t i = 0; i < s.buffers.size(); ++i) {
+            const ThreadBuffer* buffer = s.buffers[i];
+            std::fprintf(out, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                              "\"args\": {\"name\": \"thread %d\"}}",
+                         first ? "" : ",\n", buffer->tid, buffer->tid);
+            first = false;
+
+            for (size_t j = 0; j < buffer->events.size(); ++j) {
+                const Event& e = buffer->events[j];
+                std::fprintf(out, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                                  "\"ts\": %.3f, \"dur\": %.3f}",
+                             e.name, e.category, buffer->tid, e.start / 1000.0, e.duration / 1000.0);
+            }
+        }
+        std::fprintf(out, "\n]}\n");
+        std::fclose(out);
+    }
+
+private:
+    struct Event {
+        const char* name;
+        const char* category;
+        long long start;
+        long long duration;
+    };
+
+    struct ThreadBuffer {
+        int tid;
+        std::vector<Event> events;
+    };
+
+    struct State {
+        const char* path;
+        std::chrono::steady_clock::time_point origin;
+        std::mutex mutex;
+        std::vector<ThreadBuffer*> buffers;
+
+        State() : path(std::getenv("BIGINT_TRACE")), origin(std::chrono::steady_clock::now()) {
+            if (path && !*path) path = nullptr;
+            if (path) std::atexit(&Trace::write);
+        }
+    };
+
+    // Состояние и буферы потоков не освобождаются: они нужны обработчику atexit,
+    // который выполняется после завершения рабочих потоков
+    static State& state() {
+        static State* s = new State();
+        return *s;
+    }
+
+    static ThreadBuffer& threadBuffer() {
+        static thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            State& s = state();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            buffer = new ThreadBuffer();
+            buffer->tid = static_cast<int>(s.buffers.size()) + 1;
+            s.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/**
+ * Отрезок трассы до конца текущего блока: TRACE_SPAN("modPow") или TRACE_SPAN("aks.step", "aks")
+ */
+#define TRACE_SPAN(...) Trace::Span TRACE_CONCAT(traceSpan, __LINE__)(__VA_ARGS__)
+
+#endif